@@ -0,0 +1,156 @@
+/**
+ * @file bench_first_call.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief Benchmark of the first-call latency of `eigen_decomposition`, with
+ * and without `warmup`.
+ *
+ * Start-up costs are paid once per process, so every measurement runs in a
+ * freshly forked child that has not touched LAPACK yet. For each matrix order
+ * the child either calls `eigen_decomposition` straight away or first calls
+ * `warmup`; it then times the first decomposition and the median of the
+ * following ones (the steady state) and reports them through a pipe.
+ */
+
+#include "eigen_interface.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+const int steady_calls = 51;
+
+struct Timings
+{
+    double warmup_us;
+    double first_us;
+    double steady_us;
+};
+
+double elapsed_us(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+Timings measure(int n, bool warm)
+{
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(n, n);
+    Eigen::VectorXd W;
+    Eigen::MatrixXd V;
+    Timings t{0.0, 0.0, 0.0};
+
+    auto start = std::chrono::steady_clock::now();
+    if (warm)
+    {
+        if (warmup(n, 1) == 0)
+        {
+            std::cerr << "warmup: the workspace of order " << n
+                      << " does not fit under the pool's memory cap\n";
+        }
+        t.warmup_us = elapsed_us(start);
+    }
+
+    start = std::chrono::steady_clock::now();
+    eigen_decomposition(A, W, V);
+    t.first_us = elapsed_us(start);
+
+    std::vector<double> steady(steady_calls);
+    for (double &s : steady)
+    {
+        start = std::chrono::steady_clock::now();
+        eigen_decomposition(A, W, V);
+        s = elapsed_us(start);
+    }
+    std::nth_element(steady.begin(), steady.begin() + steady_calls / 2,
+                     steady.end());
+    t.steady_us = steady[steady_calls / 2];
+    return t;
+}
+
+/**
+ * @brief Run `measure` in a forked child, so it sees a cold process.
+ */
+Timings measure_in_child(int n, bool warm)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+        throw std::runtime_error("pipe failed");
+    const pid_t pid = fork();
+    if (pid < 0)
+        throw std::runtime_error("fork failed");
+    if (pid == 0)
+    {
+        close(fds[0]);
+        int status = 0;
+        try
+        {
+            const Timings t = measure(n, warm);
+            if (write(fds[1], &t, sizeof t) != sizeof t)
+                status = 1;
+        }
+        catch (...)
+        {
+            status = 1;
+        }
+        _exit(status);
+    }
+
+    close(fds[1]);
+    Timings t;
+    const ssize_t got = read(fds[0], &t, sizeof t);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (got != sizeof t || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        throw std::runtime_error("measurement in child process failed");
+    return t;
+}
+
+} // namespace
+
+/**
+ * @brief The main entry point of the benchmark.
+ *
+ * @return Returns 0 if the program executed successfully, 1 otherwise.
+ */
+int main()
+{
+    // The parent must stay cold: it never calls into LAPACK itself.
+    std::cout << "Latency of eigen_decomposition in microseconds, each "
+                 "measured in a fresh process\n";
+    std::cout << std::setw(6) << "n" << std::setw(12) << "first"
+              << std::setw(12) << "steady" << std::setw(8) << "ratio"
+              << std::setw(12) << "warmup" << std::setw(14) << "first (warm)"
+              << std::setw(8) << "ratio" << std::endl;
+    try
+    {
+        for (int n : {8, 32, 128, 512})
+        {
+            const Timings cold = measure_in_child(n, false);
+            const Timings warm = measure_in_child(n, true);
+            std::cout << std::fixed << std::setprecision(1) << std::setw(6)
+                      << n << std::setw(12) << cold.first_us << std::setw(12)
+                      << cold.steady_us << std::setw(8)
+                      << cold.first_us / cold.steady_us << std::setw(12)
+                      << warm.warmup_us << std::setw(14) << warm.first_us
+                      << std::setw(8) << warm.first_us / warm.steady_us
+                      << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in first-call benchmark: " << e.what()
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
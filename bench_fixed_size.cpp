@@ -0,0 +1,207 @@
+/**
+ * @file bench_fixed_size.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief Benchmark of the fixed-size eigensolvers against the dynamic
+ * `eigen_decomposition` path.
+ *
+ * For each of the sizes 6, 12, 24 and 32 a batch of random matrices is
+ * decomposed once through `fixed_eigen_decomposition`, or
+ * `fixed_symmetric_eigen_decomposition` and
+ * `fixed_jacobi_eigen_decomposition`, and once through the LAPACK backed
+ * `eigen_decomposition`, which runs `dgeev` on the general matrices and
+ * `dsyevr` on the symmetric ones.
+ *
+ * Before anything is timed, every fixed-size result is checked: its
+ * residual ||A V - V W|| / ||A|| must be below 100 N eps and its
+ * eigenvalues must agree with LAPACK's to the same relative tolerance. A
+ * failed check stops the benchmark rather than printing a speedup. The
+ * average time per decomposition and the resulting speedup are printed to
+ * the console, with the largest residual seen.
+ */
+
+#include "eigen_interface.h"
+#include "fixed_size_eigen.h"
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int batch_size = 2000;
+
+template <typename F>
+double time_per_call_ns(int calls, F &&f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < calls; ++i)
+        f(i);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           calls;
+}
+
+/**
+ * @brief Check a fixed-size result and return its residual.
+ *
+ * @param WR The real parts of the eigenvalues, in the layout of `dgeev`.
+ * @param WI Their imaginary parts.
+ * @param V The eigenvectors; a complex pair in columns j and j + 1.
+ * @param reference The real parts of the eigenvalues from LAPACK.
+ * @throws std::runtime_error if the residual or the eigenvalues are off.
+ */
+double check(const std::string &solver, const Eigen::MatrixXd &A,
+             const Eigen::VectorXd &WR, const Eigen::VectorXd &WI,
+             const Eigen::MatrixXd &V, const Eigen::VectorXd &reference)
+{
+    const Eigen::Index n = A.rows();
+    const double tolerance =
+        100.0 * n * std::numeric_limits<double>::epsilon();
+
+    Eigen::MatrixXcd Vc(n, n);
+    Eigen::VectorXcd L(n);
+    for (Eigen::Index j = 0; j < n; ++j)
+    {
+        L(j) = {WR(j), WI(j)};
+        if (WI(j) != 0.0 && j + 1 < n)
+        {
+            for (Eigen::Index i = 0; i < n; ++i)
+            {
+                Vc(i, j) = {V(i, j), V(i, j + 1)};
+                Vc(i, j + 1) = {V(i, j), -V(i, j + 1)};
+            }
+            L(j + 1) = {WR(j + 1), WI(j + 1)};
+            ++j;
+        }
+        else
+        {
+            Vc.col(j) = V.col(j).cast<std::complex<double>>();
+        }
+    }
+    const double norm = A.norm();
+    const double residual =
+        (A.cast<std::complex<double>>() * Vc - Vc * L.asDiagonal()).norm() /
+        norm;
+
+    std::vector<double> mine(WR.data(), WR.data() + n);
+    std::vector<double> theirs(reference.data(), reference.data() + n);
+    std::sort(mine.begin(), mine.end());
+    std::sort(theirs.begin(), theirs.end());
+    double deviation = 0.0;
+    for (Eigen::Index j = 0; j < n; ++j)
+        deviation = std::max(deviation, std::abs(mine[j] - theirs[j]) / norm);
+
+    if (!(residual <= tolerance) || !(deviation <= tolerance))
+    {
+        throw std::runtime_error(
+            solver + " of order " + std::to_string(n) + ": residual " +
+            std::to_string(residual) + ", eigenvalue deviation " +
+            std::to_string(deviation) + " exceed " +
+            std::to_string(tolerance));
+    }
+    return residual;
+}
+
+template <int N>
+void run_size()
+{
+    using Matrix = Eigen::Matrix<double, N, N>;
+    using Vector = Eigen::Matrix<double, N, 1>;
+
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix>> general(batch_size);
+    std::vector<Matrix, Eigen::aligned_allocator<Matrix>> symmetric(batch_size);
+    for (int i = 0; i < batch_size; ++i)
+    {
+        general[i] = Matrix::Random();
+        symmetric[i] = general[i] + general[i].transpose();
+    }
+
+    Vector W;
+    Vector WI;
+    Matrix V;
+    Eigen::VectorXd W_dyn;
+    Eigen::MatrixXd V_dyn;
+
+    // Agreement with LAPACK first
+    double worst = 0.0;
+    const Vector zero = Vector::Zero();
+    for (int i = 0; i < batch_size; ++i)
+    {
+        eigen_decomposition(general[i], W_dyn, V_dyn);
+        fixed_eigen_decomposition<N>(general[i], W, WI, V);
+        worst = std::max(worst, check("fixed QR", general[i], W, WI, V,
+                                      W_dyn));
+
+        eigen_decomposition(symmetric[i], W_dyn, V_dyn);
+        fixed_symmetric_eigen_decomposition<N>(symmetric[i], W, V);
+        worst = std::max(worst, check("fixed QL", symmetric[i], W, zero, V,
+                                      W_dyn));
+        fixed_jacobi_eigen_decomposition<N>(symmetric[i], W, V);
+        worst = std::max(worst, check("fixed Jacobi", symmetric[i], W, zero,
+                                      V, W_dyn));
+    }
+
+    double fixed_general = time_per_call_ns(batch_size, [&](int i) {
+        fixed_eigen_decomposition<N>(general[i], W, V);
+    });
+    double dynamic_general = time_per_call_ns(batch_size, [&](int i) {
+        eigen_decomposition(general[i], W_dyn, V_dyn);
+    });
+    double fixed_symmetric = time_per_call_ns(batch_size, [&](int i) {
+        fixed_symmetric_eigen_decomposition<N>(symmetric[i], W, V);
+    });
+    double fixed_jacobi = time_per_call_ns(batch_size, [&](int i) {
+        fixed_jacobi_eigen_decomposition<N>(symmetric[i], W, V);
+    });
+    double dynamic_symmetric = time_per_call_ns(batch_size, [&](int i) {
+        eigen_decomposition(symmetric[i], W_dyn, V_dyn);
+    });
+
+    std::cout << std::setw(4) << N << std::setw(12) << fixed_general
+              << std::setw(12) << dynamic_general << std::setw(9)
+              << dynamic_general / fixed_general << std::setw(12)
+              << fixed_symmetric << std::setw(12) << fixed_jacobi
+              << std::setw(12) << dynamic_symmetric << std::setw(9)
+              << dynamic_symmetric / fixed_symmetric << std::setw(12)
+              << worst << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief The main entry point of the benchmark.
+ *
+ * @return Returns 0 if the program executed successfully, 1 otherwise.
+ */
+int main()
+{
+    std::cout << "Average time per decomposition in ns (" << batch_size
+              << " matrices per size); speedups of fixed QR over dgeev and "
+                 "fixed QL over dsyevr\n";
+    std::cout << std::setw(4) << "N" << std::setw(12) << "fixed QR"
+              << std::setw(12) << "dgeev" << std::setw(9) << "speedup"
+              << std::setw(12) << "fixed QL" << std::setw(12) << "Jacobi"
+              << std::setw(12) << "dsyevr" << std::setw(9) << "speedup"
+              << std::setw(12) << "residual" << std::endl;
+    try
+    {
+        run_size<6>();
+        run_size<12>();
+        run_size<24>();
+        run_size<32>();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in fixed-size benchmark: " << e.what()
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
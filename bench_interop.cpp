@@ -0,0 +1,210 @@
+/**
+ * @file bench_interop.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief Microbenchmark of the layers between a C++ caller and `dgeev`.
+ *
+ * For n = 2 ... 512 the same matrix is decomposed through each layer of the
+ * binding, from the bottom up:
+ * - `dgeev_` called directly from C++ with a preallocated workspace of the
+ *   optimal length;
+ * - the Fortran shim `eigen_decomposition_ws` (the bind(C) call with a
+ *   caller-owned workspace);
+ * - the original Fortran shim `eigen_decomposition`, which allocates its
+ *   workspace and eigenvalue arrays on every call. It only uses the minimal
+ *   workspace of 4n, which changes LAPACK's blocking, so it is compared with
+ *   a direct `dgeev_` call using the same workspace length;
+ * - the C++ wrapper `eigen_decomposition(A, W, V)`. It pads the leading
+ *   dimension of its workspace, which at powers of two can make it faster
+ *   than the unpadded direct call.
+ * The inputs of the first three are restored outside the timed region. In
+ * addition, the pieces of work the wrapper does around the call are timed on
+ * their own: evaluating A into the workspace, a fresh W/V allocation and a
+ * workspace lease from the pool. All numbers are medians in nanoseconds.
+ */
+
+#include "eigen_interface.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#ifdef LAPACK_SUFFIX64
+#define dgeev_ dgeev_64_
+#endif
+
+extern "C"
+{
+    // Reference LAPACK, with the hidden lengths of the character arguments
+    void dgeev_(const char *jobvl, const char *jobvr, const lapack_int *n,
+                double *A, const lapack_int *lda, double *wr, double *wi,
+                double *vl, const lapack_int *ldvl, double *vr,
+                const lapack_int *ldvr, double *work, const lapack_int *lwork,
+                lapack_int *info, std::size_t jobvl_len,
+                std::size_t jobvr_len);
+}
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ns_since(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start)
+        .count();
+}
+
+double median(std::vector<double> &samples)
+{
+    const auto mid = samples.begin() + samples.size() / 2;
+    std::nth_element(samples.begin(), mid, samples.end());
+    return *mid;
+}
+
+/**
+ * @brief Enough repetitions for stable medians without running for minutes.
+ */
+int repetitions(lapack_int n)
+{
+    const double cube = static_cast<double>(n) * n * n;
+    return std::clamp(static_cast<int>(2e7 / (cube + 1e3)), 5, 2001);
+}
+
+void run_size(lapack_int n)
+{
+    const Eigen::MatrixXd A = Eigen::MatrixXd::Random(n, n);
+    const std::size_t nn = static_cast<std::size_t>(n) * n;
+    const int reps = repetitions(n);
+
+    lapack_int lwork = 0;
+    lapack_int info = 0;
+    eigen_workspace_query(n, 'V', &lwork, &info);
+    // the workspace length of the allocating Fortran shim
+    const lapack_int minimal_lwork = std::max<lapack_int>(1, 4 * n);
+    lwork = std::max(lwork, minimal_lwork);
+    std::vector<double> a(nn), wr(n), wi(n), v(nn), work(lwork), vl(1);
+    Eigen::VectorXd W;
+    Eigen::MatrixXd V;
+    const lapack_int ld = n;
+    const lapack_int one = 1;
+
+    enum
+    {
+        Direct,
+        DirectMinimal,
+        Shim,
+        FortranAlloc,
+        Wrapper,
+        Copy,
+        Resize,
+        Lease,
+        Layers
+    };
+    std::vector<std::vector<double>> samples(Layers,
+                                             std::vector<double>(reps));
+
+    for (int r = 0; r < reps; ++r)
+    {
+        std::memcpy(a.data(), A.data(), nn * sizeof(double));
+        auto start = Clock::now();
+        dgeev_("N", "V", &n, a.data(), &ld, wr.data(), wi.data(), vl.data(),
+               &one, v.data(), &ld, work.data(), &lwork, &info, 1, 1);
+        samples[Direct][r] = ns_since(start);
+
+        std::memcpy(a.data(), A.data(), nn * sizeof(double));
+        start = Clock::now();
+        dgeev_("N", "V", &n, a.data(), &ld, wr.data(), wi.data(), vl.data(),
+               &one, v.data(), &ld, work.data(), &minimal_lwork, &info, 1,
+               1);
+        samples[DirectMinimal][r] = ns_since(start);
+
+        std::memcpy(a.data(), A.data(), nn * sizeof(double));
+        start = Clock::now();
+        eigen_decomposition_ws(n, a.data(), n, 'V', wr.data(), wi.data(),
+                               v.data(), n, work.data(), lwork, &info);
+        samples[Shim][r] = ns_since(start);
+
+        std::memcpy(a.data(), A.data(), nn * sizeof(double));
+        start = Clock::now();
+        eigen_decomposition(n, a.data(), wr.data(), v.data(), &info);
+        samples[FortranAlloc][r] = ns_since(start);
+
+        start = Clock::now();
+        eigen_decomposition(A, W, V);
+        samples[Wrapper][r] = ns_since(start);
+
+        {
+            auto ws = eigen_interface_detail::lease_eigen_workspace(n);
+            start = Clock::now();
+            Eigen::Map<Eigen::MatrixXd, Eigen::Aligned16,
+                       Eigen::OuterStride<>>(ws.a, n, n,
+                                             Eigen::OuterStride<>(ws.lda))
+                .noalias() = A;
+            samples[Copy][r] = ns_since(start);
+        }
+
+        start = Clock::now();
+        {
+            Eigen::VectorXd W_new(n);
+            Eigen::MatrixXd V_new(n, n);
+            W_new(0) = V_new(0, 0) = 0.0;
+        }
+        samples[Resize][r] = ns_since(start);
+
+        start = Clock::now();
+        {
+            auto ws = eigen_interface_detail::lease_eigen_workspace(n);
+            ws.a[0] = 0.0;
+        }
+        samples[Lease][r] = ns_since(start);
+    }
+
+    double t[Layers];
+    for (int l = 0; l < Layers; ++l)
+        t[l] = median(samples[l]);
+
+    std::cout << std::fixed << std::setprecision(0) << std::setw(5) << n
+              << std::setw(13) << t[Direct] << std::setw(10)
+              << t[Shim] - t[Direct] << std::setw(11)
+              << t[FortranAlloc] - t[DirectMinimal] - (t[Shim] - t[Direct])
+              << std::setw(10)
+              << t[Wrapper] - t[Direct] << std::setw(9) << t[Copy]
+              << std::setw(9) << t[Resize] << std::setw(9) << t[Lease]
+              << std::setw(8) << std::setprecision(1)
+              << 100.0 * (t[Wrapper] - t[Direct]) / t[Wrapper] << "%"
+              << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief The main entry point of the benchmark.
+ *
+ * @return Returns 0 if the program executed successfully, 1 otherwise.
+ */
+int main()
+{
+    std::cout << "Median cost per layer in ns. The bind(C), Fortran allocate "
+                 "and wrapper\ncolumns are the extra time over the layer "
+                 "below (over dgeev_ for the wrapper).\n";
+    std::cout << std::setw(5) << "n" << std::setw(13) << "dgeev_"
+              << std::setw(10) << "+bind(C)" << std::setw(11) << "+F alloc"
+              << std::setw(10) << "+wrapper" << std::setw(9) << "copy"
+              << std::setw(9) << "resize" << std::setw(9) << "lease"
+              << std::setw(9) << "overhead" << std::endl;
+    try
+    {
+        for (lapack_int n = 2; n <= 512; n *= 2)
+            run_size(n);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in interop benchmark: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
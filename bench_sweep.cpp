@@ -0,0 +1,472 @@
+/**
+ * @file bench_sweep.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief Size sweep of the eigen decomposition across backends, BLAS
+ * thread counts and thread placement policies, with a checkpoint journal.
+ *
+ * Every configuration (backend, n, threads, policy) is timed several times
+ * and its raw samples are appended to the journal as one line as soon as it
+ * is done:
+ *
+ *     <backend> <n> <threads> <count> <seconds> ...
+ *         [energy <pkg> <dram>] [policy <name>] end
+ *
+ * Before timing, the BLAS team is started with one untimed decomposition
+ * and the placement policy (see thread_affinity.h) is applied to it. The
+ * report gives the coefficient of variation of the samples and, for pinned
+ * configurations, the reduction of the variance relative to the unpinned
+ * ("none") configuration with the same backend, n and threads.
+ *
+ * Where the RAPL counters are readable (see energy_meter.h), the package
+ * and DRAM energy of all repetitions together is recorded in joules, and
+ * the report adds the energy per decomposition and GFLOP/J, counting 25 n^3
+ * flops per decomposition. The counters are read around the whole timed
+ * loop rather than around every repetition, since they only update about
+ * once per millisecond.
+ *
+ * Lines are written with a single write() under an exclusive flock(), so
+ * several sweeps on the same machine can share a journal, and a crash loses
+ * at most the configuration that was running. A line torn by a crash lacks
+ * its closing "end" and is ignored; the next writer starts a new line after
+ * it. With `--resume` the configurations already in the journal are
+ * skipped. `--shard=i/k` runs only every k-th configuration starting at the
+ * i-th, so k concurrent processes with the same options split a sweep
+ * between them.
+ *
+ * Usage: bench_sweep [--journal=FILE] [--resume] [--shard=i/k]
+ *                    [--sizes=n,n,...] [--threads=t,t,...]
+ *                    [--backends=fortran,eigen]
+ *                    [--policies=none,compact,scatter,physical,explicit]
+ *                    [--cpus=c,c,...] (the CPU list of "explicit")
+ */
+
+#include "blas_threads.h"
+#include "eigen_interface.h"
+#include "energy_meter.h"
+#include "parallel.h"
+#include "thread_affinity.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/file.h>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+struct Config
+{
+    std::string backend;
+    int n;
+    unsigned threads;
+    std::string policy = "none";
+};
+
+using ConfigKey = std::tuple<std::string, int, unsigned, std::string>;
+
+struct Result
+{
+    std::vector<double> samples; ///< seconds per repetition
+    bool has_energy = false;
+    EnergyUsage energy; ///< of all repetitions
+};
+
+ConfigKey key(const Config &c)
+{
+    return ConfigKey(c.backend, c.n, c.threads, c.policy);
+}
+
+struct Options
+{
+    std::string journal = "sweep.journal";
+    bool resume = false;
+    unsigned shard = 0;
+    unsigned shards = 1;
+    std::vector<int> sizes = {64, 128, 256, 512, 1024, 2048};
+    std::vector<unsigned> threads;
+    std::vector<std::string> backends = {"fortran", "eigen"};
+    std::vector<std::string> policies = {"none"};
+    std::vector<int> cpus;
+};
+
+[[noreturn]] void fail(const std::string &what)
+{
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+std::vector<std::string> split(const std::string &text, char separator)
+{
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator))
+        parts.push_back(part);
+    return parts;
+}
+
+Options parse_options(int argc, char *argv[])
+{
+    Options options;
+    const unsigned hardware = default_thread_count();
+    options.threads = {1};
+    if (hardware > 1)
+        options.threads.push_back(hardware);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const std::size_t eq = arg.find('=');
+        const std::string name = arg.substr(0, eq);
+        const std::string value =
+            eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (name == "--journal" && !value.empty())
+            options.journal = value;
+        else if (arg == "--resume")
+            options.resume = true;
+        else if (name == "--shard")
+        {
+            const std::vector<std::string> parts = split(value, '/');
+            if (parts.size() != 2)
+                throw std::invalid_argument("--shard expects i/k: " + arg);
+            options.shard = std::stoul(parts[0]);
+            options.shards = std::stoul(parts[1]);
+            if (options.shards == 0 || options.shard >= options.shards)
+                throw std::invalid_argument("--shard needs 0 <= i < k: " +
+                                            arg);
+        }
+        else if (name == "--sizes")
+        {
+            options.sizes.clear();
+            for (const std::string &s : split(value, ','))
+                options.sizes.push_back(std::stoi(s));
+        }
+        else if (name == "--threads")
+        {
+            options.threads.clear();
+            for (const std::string &s : split(value, ','))
+                options.threads.push_back(std::stoul(s));
+        }
+        else if (name == "--backends")
+        {
+            options.backends = split(value, ',');
+            for (const std::string &b : options.backends)
+            {
+                if (b != "fortran" && b != "eigen")
+                    throw std::invalid_argument("unknown backend: " + b);
+            }
+        }
+        else if (name == "--policies")
+        {
+            options.policies = split(value, ',');
+            for (const std::string &p : options.policies)
+                parse_affinity_policy(p);
+        }
+        else if (name == "--cpus")
+        {
+            options.cpus.clear();
+            for (const std::string &s : split(value, ','))
+                options.cpus.push_back(std::stoi(s));
+        }
+        else
+            throw std::invalid_argument("unknown option: " + arg);
+    }
+    if (options.sizes.empty() || options.threads.empty() ||
+        options.backends.empty() || options.policies.empty())
+    {
+        throw std::invalid_argument(
+            "empty sizes, threads, backends or policies");
+    }
+    if (options.cpus.empty() &&
+        std::count(options.policies.begin(), options.policies.end(),
+                   "explicit") != 0)
+        throw std::invalid_argument("the explicit policy needs --cpus");
+    return options;
+}
+
+/**
+ * @brief The configurations of the whole sweep, largest n last, so a
+ * partial sweep still covers all backends and thread counts.
+ */
+std::vector<Config> sweep_configs(const Options &options)
+{
+    std::vector<Config> configs;
+    for (int n : options.sizes)
+        for (unsigned t : options.threads)
+            for (const std::string &b : options.backends)
+                for (const std::string &p : options.policies)
+                    configs.push_back({b, n, t, p});
+    return configs;
+}
+
+/**
+ * @brief Read the complete lines of the journal, keyed by configuration.
+ *
+ * A configuration that was recorded more than once keeps its last samples.
+ */
+std::map<ConfigKey, Result> read_journal(const std::string &path)
+{
+    std::map<ConfigKey, Result> done;
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        if (errno == ENOENT)
+            return done;
+        fail("cannot open journal " + path);
+    }
+    flock(fd, LOCK_SH);
+    std::string text;
+    char buffer[1 << 16];
+    ssize_t got;
+    while ((got = read(fd, buffer, sizeof buffer)) > 0)
+        text.append(buffer, got);
+    flock(fd, LOCK_UN);
+    close(fd);
+    if (got < 0)
+        fail("cannot read journal " + path);
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        std::istringstream fields(line);
+        Config c;
+        std::size_t count = 0;
+        if (!(fields >> c.backend >> c.n >> c.threads >> count) ||
+            count > line.size())
+            continue;
+        Result result;
+        result.samples.resize(count);
+        for (double &s : result.samples)
+            fields >> s;
+        std::string end, extra;
+        fields >> end;
+        if (end == "energy")
+        {
+            result.has_energy = true;
+            fields >> result.energy.package >> result.energy.dram >> end;
+            result.energy.has_dram = result.energy.dram > 0.0;
+        }
+        if (end == "policy")
+            fields >> c.policy >> end;
+        if (fields && end == "end" && !(fields >> extra))
+            done[key(c)] = std::move(result);
+    }
+    return done;
+}
+
+/**
+ * @brief Append the samples of one configuration to the journal.
+ */
+void append_journal(const std::string &path, const Config &c,
+                    const Result &result)
+{
+    std::ostringstream line;
+    line << c.backend << ' ' << c.n << ' ' << c.threads << ' '
+         << result.samples.size() << std::setprecision(9);
+    for (double s : result.samples)
+        line << ' ' << s;
+    if (result.has_energy)
+    {
+        line << " energy " << result.energy.package << ' '
+             << result.energy.dram;
+    }
+    if (c.policy != "none")
+        line << " policy " << c.policy;
+    line << " end\n";
+    std::string text = line.str();
+
+    const int fd = open(path.c_str(), O_RDWR | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+        fail("cannot open journal " + path);
+    flock(fd, LOCK_EX);
+    // Do not extend a line torn by a crash
+    const off_t size = lseek(fd, 0, SEEK_END);
+    char last = '\n';
+    if (size > 0 && pread(fd, &last, 1, size - 1) == 1 && last != '\n')
+        text.insert(0, 1, '\n');
+    const ssize_t written = write(fd, text.data(), text.size());
+    const bool synced = fsync(fd) == 0;
+    flock(fd, LOCK_UN);
+    close(fd);
+    if (written != static_cast<ssize_t>(text.size()) || !synced)
+        fail("cannot append to journal " + path);
+}
+
+/**
+ * @brief Repetitions per configuration: about a second of work at small n,
+ * at least three runs at large n.
+ */
+int repetitions(int n)
+{
+    const double cube = static_cast<double>(n) * n * n;
+    return std::clamp(static_cast<int>(1e9 / (25.0 * cube)), 3, 51);
+}
+
+void decompose(const Config &c, const Eigen::MatrixXd &A, Eigen::VectorXd &W,
+               Eigen::MatrixXd &V)
+{
+    if (c.backend == "fortran")
+        eigen_decomposition(A, W, V);
+    else
+    {
+        Eigen::EigenSolver<Eigen::MatrixXd> solver(A);
+        W = solver.eigenvalues().real();
+        V = solver.eigenvectors().real();
+    }
+}
+
+Result measure(const Config &c, const std::vector<int> &cpus,
+               const EnergyMeter &meter)
+{
+    set_blas_threads(c.threads);
+    const Eigen::MatrixXd A = Eigen::MatrixXd::Random(c.n, c.n);
+    Eigen::VectorXd W;
+    Eigen::MatrixXd V;
+    decompose(c, A, W, V);
+    apply_placement({parse_affinity_policy(c.policy), cpus});
+    Result result;
+    result.samples.resize(repetitions(c.n));
+    const EnergyMeter::Reading energy_start = meter.read();
+    for (double &s : result.samples)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        decompose(c, A, W, V);
+        s = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          start)
+                .count();
+    }
+    if (meter.available())
+    {
+        result.has_energy = true;
+        result.energy = meter.since(energy_start);
+    }
+    return result;
+}
+
+double median(std::vector<double> samples)
+{
+    const auto mid = samples.begin() + samples.size() / 2;
+    std::nth_element(samples.begin(), mid, samples.end());
+    return *mid;
+}
+
+double mean(const std::vector<double> &samples)
+{
+    double sum = 0.0;
+    for (double s : samples)
+        sum += s;
+    return sum / samples.size();
+}
+
+double variance(const std::vector<double> &samples)
+{
+    const double m = mean(samples);
+    double sum = 0.0;
+    for (double s : samples)
+        sum += (s - m) * (s - m);
+    return samples.size() > 1 ? sum / (samples.size() - 1) : 0.0;
+}
+
+} // namespace
+
+/**
+ * @brief The main entry point of the benchmark.
+ *
+ * @return Returns 0 if the program executed successfully, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const Options options = parse_options(argc, argv);
+        const std::vector<Config> configs = sweep_configs(options);
+        const EnergyMeter meter;
+        std::map<ConfigKey, Result> done;
+        if (options.resume)
+            done = read_journal(options.journal);
+
+        std::vector<Config> mine;
+        for (std::size_t i = options.shard; i < configs.size();
+             i += options.shards)
+            mine.push_back(configs[i]);
+
+        std::size_t skipped = 0;
+        for (const Config &c : mine)
+        {
+            if (done.count(key(c)) != 0)
+            {
+                ++skipped;
+                continue;
+            }
+            Result result = measure(c, options.cpus, meter);
+            append_journal(options.journal, c, result);
+            done[key(c)] = std::move(result);
+        }
+
+        std::cout << "Shard " << options.shard << "/" << options.shards
+                  << ": " << mine.size() << " configurations, " << skipped
+                  << " resumed from " << options.journal << "\n";
+        if (!meter.available())
+            std::cout << "RAPL energy counters are not available\n";
+        std::cout << std::setw(9) << "backend" << std::setw(7) << "n"
+                  << std::setw(9) << "threads" << std::setw(10) << "policy"
+                  << std::setw(7) << "runs" << std::setw(14) << "median [s]"
+                  << std::setw(8) << "cv %" << std::setw(12) << "var. red."
+                  << std::setw(12) << "J/run" << std::setw(10) << "GFLOP/J"
+                  << std::endl;
+        for (const Config &c : mine)
+        {
+            const Result &result = done[key(c)];
+            const double var = variance(result.samples);
+            std::cout << std::setw(9) << c.backend << std::setw(7) << c.n
+                      << std::setw(9) << c.threads << std::setw(10)
+                      << c.policy << std::setw(7) << result.samples.size()
+                      << std::setw(14) << std::setprecision(6)
+                      << median(result.samples) << std::setw(8)
+                      << std::setprecision(3)
+                      << 100.0 * std::sqrt(var) / mean(result.samples);
+
+            // Variance reduction against the unpinned configuration
+            Config unpinned = c;
+            unpinned.policy = "none";
+            const auto base = done.find(key(unpinned));
+            const double base_var =
+                base != done.end() ? variance(base->second.samples) : 0.0;
+            if (c.policy != "none" && base_var > 0.0)
+                std::cout << std::setw(11) << 100.0 * (1.0 - var / base_var)
+                          << "%";
+            else
+                std::cout << std::setw(12) << "-";
+            const double joules =
+                result.energy.total() / result.samples.size();
+            if (result.has_energy && joules > 0.0)
+            {
+                const double flops =
+                    25.0 * c.n * c.n * static_cast<double>(c.n);
+                std::cout << std::setw(12) << std::setprecision(4) << joules
+                          << std::setw(10) << flops / joules * 1e-9;
+            }
+            else
+                std::cout << std::setw(12) << "n/a" << std::setw(10) << "n/a";
+            std::cout << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in sweep benchmark: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
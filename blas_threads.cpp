@@ -0,0 +1,71 @@
+/**
+ * @file blas_threads.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the BLAS threading helpers.
+ */
+
+#include "blas_threads.h"
+#include <cstddef>
+#include <dlfcn.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace
+{
+
+using SetThreads = void (*)(int);
+using GetThreads = int (*)();
+
+template <typename F>
+F lookup(const char *name)
+{
+    return reinterpret_cast<F>(dlsym(RTLD_DEFAULT, name));
+}
+
+} // namespace
+
+bool set_blas_threads(unsigned threads)
+{
+    static const auto openblas =
+        lookup<SetThreads>("openblas_set_num_threads");
+    static const auto blis = lookup<SetThreads>("bli_thread_set_num_threads");
+    if (openblas != nullptr)
+        openblas(static_cast<int>(threads));
+    else if (blis != nullptr)
+        blis(static_cast<int>(threads));
+    return openblas != nullptr || blis != nullptr;
+}
+
+unsigned blas_threads()
+{
+    static const auto openblas =
+        lookup<GetThreads>("openblas_get_num_threads");
+    static const auto blis = lookup<GetThreads>("bli_thread_get_num_threads");
+    if (openblas != nullptr)
+        return static_cast<unsigned>(openblas());
+    if (blis != nullptr)
+        return static_cast<unsigned>(blis());
+    return 0;
+}
+
+bool pin_blas_worker(unsigned worker, const std::vector<int> &cpus)
+{
+#ifdef __linux__
+    using SetAffinity = int (*)(int, std::size_t, cpu_set_t *);
+    static const auto openblas =
+        lookup<SetAffinity>("openblas_setaffinity");
+    if (openblas == nullptr)
+        return false;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus)
+        CPU_SET(cpu, &mask);
+    return openblas(static_cast<int>(worker), sizeof mask, &mask) == 0;
+#else
+    (void)worker;
+    (void)cpus;
+    return false;
+#endif
+}
@@ -0,0 +1,47 @@
+/**
+ * @file blas_threads.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines helpers to control the thread team of the
+ * BLAS library the program happens to be linked against.
+ *
+ * The reference BLAS, Accelerate, OpenBLAS and BLIS all differ in how their
+ * threading is configured. The helpers look up the library specific entry
+ * points at run time, so the program links against any of them; with a
+ * library that has no such entry point they do nothing.
+ */
+
+#ifndef BLAS_THREADS_H
+#define BLAS_THREADS_H
+
+#include <vector>
+
+/**
+ * @brief Set the number of threads used by BLAS (and thus LAPACK) calls.
+ *
+ * @param threads The number of threads.
+ * @return true if the BLAS library offers a way to set it.
+ */
+bool set_blas_threads(unsigned threads);
+
+/**
+ * @brief The number of threads used by BLAS calls.
+ *
+ * @return The thread count, or 0 if the BLAS library does not report it.
+ */
+unsigned blas_threads();
+
+/**
+ * @brief Pin a worker thread of the BLAS team to a CPU.
+ *
+ * Only OpenBLAS built with its own thread server offers this, through
+ * `openblas_setaffinity`, and only on Linux. Its team consists of the
+ * calling thread and blas_threads() - 1 workers, numbered from 0.
+ *
+ * @param worker The index of the worker thread.
+ * @param cpus The CPUs the worker may run on.
+ * @return true if the BLAS library pinned the worker.
+ */
+bool pin_blas_worker(unsigned worker, const std::vector<int> &cpus);
+
+#endif // BLAS_THREADS_H
@@ -10,30 +10,638 @@
  * matrix operations, and has error checking built in: if the LAPACK function
  * call fails, a runtime_error exception is thrown to indicate the failure.
  *
- * It comprises only a single function, `eigen_decomposition`, which takes as
- * input a Matrix of any dimensions and prepares it for the LAPACK call, then
- * throws an error if the operation is not successful.
+ * Besides the workspace management behind `eigen_decomposition`, which
+ * evaluates any Eigen expression straight into a padded, aligned LAPACK
+ * buffer leased from the shared `WorkspacePool`, it contains the singular
+ * value decomposition routines built on `dgesdd` and `dgesvdx`. These keep
+ * their LAPACK workspaces in an `SvdContext` so that they can be reused. The
+ * Hermitian eigensolvers hand Eigen's complex storage directly to `zheevd`
+ * and `zheevr`. The `dgeev` and `dgesdd` calls are recorded while a trace is
+ * active (see trace_recorder.h), and `dgeev` calls are sampled while a
+ * verifier runs (see sampled_verifier.h). Before `dgeev`, `solve_eigen`
+ * checks the structure of the matrix and takes the cheaper route for a
+ * diagonal, triangular or symmetric one.
  */
 
 #include "eigen_interface.h"
+#include "matrix_io.h"
+#include "parallel.h"
+#include "sampled_verifier.h"
+#include "structure_analyzer.h"
+#include "trace_recorder.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <string>
 
-void eigen_decomposition(const Eigen::MatrixXd &A, Eigen::VectorXd &W,
-                         Eigen::MatrixXd &V)
+using eigen_interface_detail::check_lapack_info;
+
+namespace
+{
+
+char svd_job(SvdMode mode)
+{
+    switch (mode)
+    {
+    case SvdMode::Full:
+        return 'A';
+    case SvdMode::Thin:
+        return 'S';
+    case SvdMode::ValuesOnly:
+        return 'N';
+    }
+    return 'N';
+}
+
+/**
+ * @brief Round a buffer length in doubles up to whole 64-byte cache lines.
+ */
+std::size_t round_to_cache_line(std::size_t count)
+{
+    return (count + 7) / 8 * 8;
+}
+
+/**
+ * @brief Scale the n columns of v to unit length, as `dgeev` returns them.
+ */
+void normalize_columns(lapack_int n, double *v, lapack_int ldv)
+{
+    for (lapack_int j = 0; j < n; ++j)
+    {
+        double *col = v + static_cast<std::size_t>(j) * ldv;
+        double sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+        for (lapack_int i = 0; i < n; ++i)
+            sum += col[i] * col[i];
+        const double scale = 1.0 / std::sqrt(sum);
+#pragma omp simd
+        for (lapack_int i = 0; i < n; ++i)
+            col[i] *= scale;
+    }
+}
+
+void transpose_in_place(lapack_int n, double *a, lapack_int lda)
+{
+    for (lapack_int j = 0; j < n; ++j)
+    {
+        for (lapack_int i = j + 1; i < n; ++i)
+        {
+            std::swap(a[i + static_cast<std::size_t>(j) * lda],
+                      a[j + static_cast<std::size_t>(i) * lda]);
+        }
+    }
+}
+
+} // namespace
+
+namespace eigen_interface_detail
+{
+
+namespace
+{
+
+/**
+ * @brief Leading dimension for an n x n matrix: a whole number of 64-byte
+ * cache lines, but not a multiple of 4 KiB.
+ */
+lapack_int padded_leading_dimension(lapack_int n)
+{
+    lapack_int lda = std::max<lapack_int>(8, (n + 7) / 8 * 8);
+    if (lda % 512 == 0)
+        lda += 8;
+    return lda;
+}
+
+} // namespace
+
+namespace
+{
+
+/**
+ * @brief Sizes, in doubles, of the buffers of an `EigenWorkspace`.
+ */
+struct EigenWorkspaceLayout
+{
+    lapack_int lda;
+    std::size_t a_size;
+    std::size_t vec_size;
+    lapack_int lwork;
+    lapack_int liwork;
+
+    /**
+     * @brief The doubles taken by the integer workspace, whole cache lines.
+     */
+    std::size_t iwork_size() const
+    {
+        return round_to_cache_line(
+            (static_cast<std::size_t>(liwork) * sizeof(lapack_int) +
+             sizeof(double) - 1) /
+            sizeof(double));
+    }
+
+    std::size_t doubles() const
+    {
+        return a_size + 2 * vec_size + round_to_cache_line(lwork) +
+               iwork_size();
+    }
+};
+
+EigenWorkspaceLayout eigen_workspace_layout(lapack_int n, char jobvr,
+                                            bool with_matrix)
+{
+    // The query results only depend on n and the job; remember the last
+    // ones per thread.
+    thread_local lapack_int query_n = -1;
+    thread_local char query_job = 0;
+    thread_local lapack_int query_lwork = 0;
+    thread_local lapack_int query_liwork = 0;
+    if (n != query_n || jobvr != query_job)
+    {
+        lapack_int info;
+        lapack_int geev_lwork;
+        eigen_workspace_query(n, jobvr, &geev_lwork, &info);
+        check_lapack_info("dgeev workspace query", info);
+        lapack_int syevr_lwork;
+        symmetric_workspace_query(n, jobvr, &syevr_lwork, &query_liwork,
+                                  &info);
+        check_lapack_info("dsyevr workspace query", info);
+        // dtrevc needs 3 n, which dgeev's workspace always exceeds
+        query_lwork = std::max(geev_lwork, syevr_lwork);
+        query_n = n;
+        query_job = jobvr;
+    }
+
+    EigenWorkspaceLayout layout;
+    layout.lda = with_matrix ? padded_leading_dimension(n)
+                             : std::max<lapack_int>(1, n);
+    check_lapack_size(layout.lda, n);
+    layout.a_size = with_matrix ? static_cast<std::size_t>(layout.lda) *
+                                      std::max<lapack_int>(1, n)
+                                : 0;
+    layout.vec_size = round_to_cache_line(std::max<lapack_int>(1, n));
+    layout.lwork = query_lwork;
+    layout.liwork = query_liwork;
+    return layout;
+}
+
+} // namespace
+
+EigenWorkspace lease_eigen_workspace(lapack_int n, char jobvr,
+                                     bool with_matrix)
+{
+    const EigenWorkspaceLayout layout =
+        eigen_workspace_layout(n, jobvr, with_matrix);
+    EigenWorkspace ws;
+    ws.lease = WorkspacePool::instance().acquire_doubles(layout.doubles());
+    ws.a = with_matrix ? ws.lease.data() : nullptr;
+    ws.lda = layout.lda;
+    ws.wr = ws.lease.data() + layout.a_size;
+    ws.wi = ws.wr + layout.vec_size;
+    ws.work = ws.wi + layout.vec_size;
+    ws.lwork = layout.lwork;
+    ws.iwork = reinterpret_cast<lapack_int *>(
+        ws.work + round_to_cache_line(layout.lwork));
+    ws.liwork = layout.liwork;
+    return ws;
+}
+
+std::size_t eigen_workspace_bytes(lapack_int n, char jobvr, bool with_matrix)
+{
+    const EigenWorkspaceLayout layout =
+        eigen_workspace_layout(n, jobvr, with_matrix);
+    return WorkspacePool::class_bytes(
+        WorkspacePool::size_class(layout.doubles() * sizeof(double)));
+}
+
+void solve_eigen_workspace(lapack_int n, char jobvr, lapack_int *lwork,
+                           lapack_int *liwork)
+{
+    const EigenWorkspaceLayout layout =
+        eigen_workspace_layout(n, jobvr, false);
+    *lwork = layout.lwork;
+    *liwork = layout.liwork;
+}
+
+StructureProfile solve_eigen(lapack_int n, double *a, lapack_int lda,
+                             char jobvr, double *wr, double *wi, double *v,
+                             lapack_int ldv, EigenWorkspace &ws)
+{
+    const StructureProfile profile = analyze_structure(a, n, n, lda);
+    solve_analyzed_eigen(profile, n, a, lda, jobvr, wr, wi, v, ldv, ws);
+    return profile;
+}
+
+void solve_analyzed_eigen(const StructureProfile &profile, lapack_int n,
+                          double *a, lapack_int lda, char jobvr, double *wr,
+                          double *wi, double *v, lapack_int ldv,
+                          EigenWorkspace &ws)
+{
+    if (!profile.finite)
+    {
+        throw std::invalid_argument(
+            "eigen_decomposition: the matrix contains NaN or Inf");
+    }
+    const bool vectors = jobvr == 'V';
+    lapack_int info;
+
+    if (profile.upper_triangular() || profile.lower_triangular())
+    {
+        for (lapack_int i = 0; i < n; ++i)
+        {
+            wr[i] = a[i + static_cast<std::size_t>(i) * lda];
+            wi[i] = 0.0;
+        }
+        if (!vectors)
+            return;
+        if (profile.diagonal())
+        {
+            for (lapack_int j = 0; j < n; ++j)
+            {
+                double *col = v + static_cast<std::size_t>(j) * ldv;
+                std::fill(col, col + n, 0.0);
+                col[j] = 1.0;
+            }
+            return;
+        }
+        // The right eigenvectors of a lower triangular L are the left ones
+        // of the upper triangular L^T
+        char side = 'R';
+        if (!profile.upper_triangular())
+        {
+            transpose_in_place(n, a, lda);
+            side = 'L';
+        }
+        triangular_eigenvectors(n, a, lda, side, v, ldv, ws.work, &info);
+        check_lapack_info("dtrevc", info);
+        normalize_columns(n, v, ldv);
+        return;
+    }
+
+    if (profile.symmetric)
+    {
+        symmetric_eigen_decomposition(n, a, lda, jobvr, wr, v, ldv, ws.work,
+                                      ws.lwork, ws.iwork, ws.liwork, &info);
+        check_lapack_info("dsyevr", info);
+        std::fill(wi, wi + n, 0.0);
+        return;
+    }
+
+    eigen_decomposition_ws(n, a, lda, jobvr, wr, wi, v, ldv, ws.work,
+                           ws.lwork, &info);
+    check_lapack_info("dgeev", info);
+}
+
+void run_eigen_decomposition(EigenWorkspace &ws, lapack_int n,
+                             Eigen::VectorXd &W, Eigen::MatrixXd &V)
 {
-    int n = A.rows();
-    Eigen::MatrixXd A_copy = A;
-    int info;
     W.resize(n);    // Ensure the output vector is resized
     V.resize(n, n); // Ensure the output matrix is resized
 
-    // Call the Fortran subroutine
-    eigen_decomposition(n, A_copy.data(), W.data(), V.data(), &info);
+    TraceCallScope trace("dgeev", 'V', ws.a, n, n, ws.lda);
+    VerifyCallScope verify(ws.a, n, ws.lda);
+    const StructureProfile profile =
+        solve_eigen(n, ws.a, ws.lda, 'V', ws.wr, ws.wi, V.data(),
+                    std::max<lapack_int>(1, n), ws);
+    trace.done(profile);
+    verify.done(ws.wr, ws.wi, V.data(), std::max<lapack_int>(1, n));
+    // Only the real parts are returned, the imaginary parts stay in ws.wi
+    std::copy(ws.wr, ws.wr + n, W.data());
+}
 
+void check_lapack_info(const char *routine, lapack_int info)
+{
     if (info != 0)
     {
-        throw std::runtime_error(
-            "LAPACK eigen_decomposition failed with info code: " +
-            std::to_string(info));
+        throw std::runtime_error(std::string("LAPACK ") + routine +
+                                 " failed with info code: " +
+                                 std::to_string(info));
+    }
+}
+
+void check_square(Eigen::Index rows, Eigen::Index cols)
+{
+    if (rows != cols)
+    {
+        throw std::invalid_argument(
+            "eigen_decomposition: matrix is " + std::to_string(rows) + "x" +
+            std::to_string(cols) + ", expected a square matrix");
+    }
+}
+
+void check_lapack_size(Eigen::Index rows, Eigen::Index cols)
+{
+    const auto limit = std::numeric_limits<lapack_int>::max();
+    if (rows > limit || cols > limit || (cols > 0 && rows > limit / cols))
+    {
+        throw std::invalid_argument(
+            "a " + std::to_string(rows) + "x" + std::to_string(cols) +
+            " matrix cannot be indexed with 32-bit LAPACK integers; build "
+            "with ILP64=1 against an ILP64 LAPACK");
+    }
+}
+
+} // namespace eigen_interface_detail
+
+void eigen_decomposition_to_file(const Eigen::MatrixXd &A,
+                                 const std::string &path)
+{
+    eigen_interface_detail::check_square(A.rows(), A.cols());
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const auto n = static_cast<lapack_int>(A.rows());
+    const std::size_t values_bytes =
+        sizeof(FrameHeader) + 2 * static_cast<std::size_t>(n) * sizeof(double);
+    const std::size_t vectors_bytes =
+        sizeof(FrameHeader) + static_cast<std::size_t>(n) * n * sizeof(double);
+    MappedFrameFile file(path, values_bytes + vectors_bytes);
+    double *wr = file.frame(0, FrameKind::Eigenvalues, n, 2);
+    double *wi = wr + n;
+    double *v = file.frame(values_bytes, FrameKind::Eigenvectors, n, n);
+
+    auto ws = eigen_interface_detail::lease_eigen_workspace(n);
+    eigen_interface_detail::load_matrix(A, ws.a, ws.lda);
+    TraceCallScope trace("dgeev", 'V', ws.a, n, n, ws.lda);
+    VerifyCallScope verify(ws.a, n, ws.lda);
+    const StructureProfile profile = eigen_interface_detail::solve_eigen(
+        n, ws.a, ws.lda, 'V', wr, wi, v, std::max<lapack_int>(1, n), ws);
+    trace.done(profile);
+    verify.done(wr, wi, v, std::max<lapack_int>(1, n));
+    file.sync();
+}
+
+unsigned warmup(int max_n, unsigned threads)
+{
+    if (max_n < 1)
+    {
+        throw std::invalid_argument("warmup: max_n = " +
+                                    std::to_string(max_n) +
+                                    " must be positive");
+    }
+    if (threads == 0)
+        threads = default_thread_count();
+
+    // gfortran runtime, symbol binding and the workspace queries
+    const Eigen::MatrixXd tiny = Eigen::MatrixXd::Random(4, 4);
+    Eigen::VectorXd W;
+    Eigen::MatrixXd V;
+    eigen_decomposition(tiny, W, V);
+    singular_values(tiny, W);
+
+    // A product large enough for a threaded BLAS to use its whole team
+    const Eigen::MatrixXd B = Eigen::MatrixXd::Random(256, 256);
+    Eigen::MatrixXd C(256, 256);
+    C.noalias() = B * B;
+
+    std::size_t bytes;
+    {
+        auto ws = eigen_interface_detail::lease_eigen_workspace(max_n);
+        bytes = ws.lease.bytes();
+    }
+    return WorkspacePool::instance().prefault(bytes, threads);
+}
+
+void SvdContext::grow(std::size_t a_size, std::size_t work_size)
+{
+    a_size = std::max(a_size_, round_to_cache_line(a_size));
+    work_size = std::max(work_size_, work_size);
+    if (a_size == a_size_ && work_size == work_size_)
+        return;
+    // The contents need not survive, so release before leasing the new block
+    buffer_.release();
+    buffer_ = WorkspacePool::instance().acquire_doubles(a_size + work_size);
+    a_size_ = a_size;
+    work_size_ = work_size;
+}
+
+void SvdContext::reserve(lapack_int m, lapack_int n, SvdMode mode)
+{
+    const char job = svd_job(mode);
+    // Both sizes first, so that a new shape leases one block, not two
+    std::size_t work_size = work_size_;
+    if (m != query_m_ || n != query_n_ || query_k_ != 0 || job != query_job_)
+    {
+        lapack_int lwork, liwork, info;
+        svd_workspace_query(m, n, job, &lwork, &liwork, &info);
+        check_lapack_info("dgesdd workspace query", info);
+        work_size = lwork;
+        if (static_cast<std::size_t>(liwork) > iwork_.size())
+            iwork_.resize(liwork);
+        query_m_ = m;
+        query_n_ = n;
+        query_k_ = 0;
+        query_job_ = job;
+    }
+    grow(static_cast<std::size_t>(m) * n, work_size);
+}
+
+void SvdContext::reserve_subset(lapack_int m, lapack_int n, lapack_int k,
+                                bool compute_vectors)
+{
+    const char job = compute_vectors ? 'V' : 'N';
+    std::size_t work_size = work_size_;
+    if (m != query_m_ || n != query_n_ || k != query_k_ || job != query_job_)
+    {
+        lapack_int lwork, liwork, info;
+        svd_subset_workspace_query(m, n, 1, k, job, &lwork, &liwork, &info);
+        check_lapack_info("dgesvdx workspace query", info);
+        work_size = lwork;
+        if (static_cast<std::size_t>(liwork) > iwork_.size())
+            iwork_.resize(liwork);
+        query_m_ = m;
+        query_n_ = n;
+        query_k_ = k;
+        query_job_ = job;
+    }
+    grow(static_cast<std::size_t>(m) * n, work_size);
+}
+
+void svd_decomposition(const Eigen::MatrixXd &A, Eigen::VectorXd &S,
+                       Eigen::MatrixXd &U, Eigen::MatrixXd &VT, SvdMode mode,
+                       SvdContext &ctx)
+{
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const lapack_int m = A.rows();
+    const lapack_int n = A.cols();
+    const lapack_int k = std::min(m, n);
+    ctx.reserve(m, n, mode);
+
+    // dgesdd destroys its input, so work on the context's copy
+    copy_matrix(A.data(), m, m, n, ctx.buffer_.data(), m);
+    S.resize(k);
+
+    double *u = nullptr;
+    double *vt = nullptr;
+    lapack_int ldu = 1;
+    lapack_int ldvt = 1;
+    if (mode != SvdMode::ValuesOnly)
+    {
+        U.resize(m, mode == SvdMode::Full ? m : k);
+        VT.resize(mode == SvdMode::Full ? n : k, n);
+        u = U.data();
+        vt = VT.data();
+        ldu = std::max<lapack_int>(1, m);
+        ldvt = std::max<lapack_int>(1, VT.rows());
     }
+
+    lapack_int info;
+    // Only a recorded call needs the structure of its input, and the scan
+    // is not counted in the recorded duration
+    StructureProfile profile;
+    if (trace_active())
+        profile = analyze_structure(ctx.buffer_.data(), m, n, m);
+    TraceCallScope trace("dgesdd", svd_job(mode), ctx.buffer_.data(), m, n, m);
+    svd_decomposition(m, n, svd_job(mode), ctx.buffer_.data(),
+                      std::max<lapack_int>(1, m), S.data(), u, ldu, vt, ldvt,
+                      ctx.buffer_.data() + ctx.a_size_,
+                      static_cast<lapack_int>(ctx.work_size_),
+                      ctx.iwork_.data(), &info);
+    check_lapack_info("dgesdd", info);
+    trace.done(profile);
+}
+
+void svd_decomposition(const Eigen::MatrixXd &A, Eigen::VectorXd &S,
+                       Eigen::MatrixXd &U, Eigen::MatrixXd &VT, SvdMode mode)
+{
+    thread_local SvdContext ctx;
+    svd_decomposition(A, S, U, VT, mode, ctx);
+}
+
+void singular_values(const Eigen::MatrixXd &A, Eigen::VectorXd &S)
+{
+    Eigen::MatrixXd unused;
+    svd_decomposition(A, S, unused, unused, SvdMode::ValuesOnly);
+}
+
+void svd_subset(const Eigen::MatrixXd &A, int k, Eigen::VectorXd &S,
+                Eigen::MatrixXd &U, Eigen::MatrixXd &VT, bool compute_vectors,
+                SvdContext &ctx)
+{
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const lapack_int m = A.rows();
+    const lapack_int n = A.cols();
+    if (k < 1 || k > std::min(m, n))
+    {
+        throw std::invalid_argument("svd_subset: k = " + std::to_string(k) +
+                                    " is out of range for a " +
+                                    std::to_string(m) + "x" +
+                                    std::to_string(n) + " matrix");
+    }
+    ctx.reserve_subset(m, n, k, compute_vectors);
+
+    // dgesvdx destroys its input as well
+    copy_matrix(A.data(), m, m, n, ctx.buffer_.data(), m);
+    // dgesvdx writes all min(m,n) entries of S as scratch
+    S.resize(std::min(m, n));
+
+    double *u = nullptr;
+    double *vt = nullptr;
+    if (compute_vectors)
+    {
+        U.resize(m, k);
+        VT.resize(k, n);
+        u = U.data();
+        vt = VT.data();
+    }
+
+    lapack_int ns, info;
+    svd_subset(m, n, 1, k, compute_vectors ? 'V' : 'N', ctx.buffer_.data(),
+               std::max<lapack_int>(1, m), &ns, S.data(), u,
+               std::max<lapack_int>(1, m), vt, k,
+               ctx.buffer_.data() + ctx.a_size_,
+               static_cast<lapack_int>(ctx.work_size_), ctx.iwork_.data(),
+               &info);
+    check_lapack_info("dgesvdx", info);
+    S.conservativeResize(ns);
+}
+
+void svd_decomposition_batched(const std::vector<Eigen::MatrixXd> &As,
+                               std::vector<Eigen::VectorXd> &S,
+                               std::vector<Eigen::MatrixXd> &U,
+                               std::vector<Eigen::MatrixXd> &VT, SvdMode mode)
+{
+    S.resize(As.size());
+    if (mode != SvdMode::ValuesOnly)
+    {
+        U.resize(As.size());
+        VT.resize(As.size());
+    }
+
+    SvdContext ctx;
+    Eigen::MatrixXd unused;
+    for (std::size_t i = 0; i < As.size(); ++i)
+    {
+        if (mode == SvdMode::ValuesOnly)
+            svd_decomposition(As[i], S[i], unused, unused, mode, ctx);
+        else
+            svd_decomposition(As[i], S[i], U[i], VT[i], mode, ctx);
+    }
+}
+
+void hermitian_eigen_decomposition(const Eigen::MatrixXcd &A,
+                                   Eigen::VectorXd &W, Eigen::MatrixXcd &V)
+{
+    V = A;
+    hermitian_eigen_decomposition_inplace(V, W);
+}
+
+void hermitian_eigen_decomposition_inplace(Eigen::MatrixXcd &A,
+                                           Eigen::VectorXd &W)
+{
+    eigen_interface_detail::check_square(A.rows(), A.cols());
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const lapack_int n = A.rows();
+    W.resize(n);
+    lapack_int info;
+    hermitian_eigen_decomposition(n, A.data(), std::max<lapack_int>(1, n), 'V',
+                                  W.data(), &info);
+    check_lapack_info("zheevd", info);
+}
+
+void hermitian_eigenvalues(const Eigen::MatrixXcd &A, Eigen::VectorXd &W)
+{
+    eigen_interface_detail::check_square(A.rows(), A.cols());
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const lapack_int n = A.rows();
+    Eigen::MatrixXcd A_copy = A;
+    W.resize(n);
+    lapack_int info;
+    hermitian_eigen_decomposition(n, A_copy.data(), std::max<lapack_int>(1, n),
+                                  'N', W.data(), &info);
+    check_lapack_info("zheevd", info);
+}
+
+void hermitian_eigen_subset(const Eigen::MatrixXcd &A, int il, int iu,
+                            Eigen::VectorXd &W, Eigen::MatrixXcd &V,
+                            bool compute_vectors)
+{
+    eigen_interface_detail::check_square(A.rows(), A.cols());
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const lapack_int n = A.rows();
+    if (il < 0 || iu < il || iu >= n)
+    {
+        throw std::invalid_argument(
+            "hermitian_eigen_subset: index range [" + std::to_string(il) +
+            ", " + std::to_string(iu) + "] is out of range for n = " +
+            std::to_string(n));
+    }
+    const int count = iu - il + 1;
+    Eigen::MatrixXcd A_copy = A;
+    // zheevr uses all n entries of W as scratch
+    W.resize(n);
+    std::complex<double> dummy;
+    std::complex<double> *z = &dummy;
+    lapack_int ldz = 1;
+    if (compute_vectors)
+    {
+        V.resize(n, count);
+        z = V.data();
+        ldz = n;
+    }
+
+    lapack_int m, info;
+    hermitian_eigen_subset(n, A_copy.data(), std::max<lapack_int>(1, n),
+                           compute_vectors ? 'V' : 'N', il + 1, iu + 1, &m,
+                           W.data(), z, ldz, &info);
+    check_lapack_info("zheevr", info);
+    W.conservativeResize(m);
 }
@@ -14,26 +14,526 @@
 #ifndef EIGEN_INTERFACE_H
 #define EIGEN_INTERFACE_H
 
+#include "layout_convert.h"
+#include "structure_analyzer.h"
+#include "workspace_pool.h"
 #include <Eigen/Dense>
+#include <complex>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Integer type of all sizes, workspace lengths and info codes passed
+ * to the Fortran binding.
+ *
+ * It is 64-bit when the library is built with `make ILP64=1` against an ILP64
+ * LAPACK, so that matrices with n > 46340 (n*n > 2^31) and their workspaces
+ * can be addressed, and int otherwise.
+ */
+#ifdef ILP64
+using lapack_int = std::int64_t;
+#else
+using lapack_int = int;
+#endif
 
 extern "C"
 {
-    void eigen_decomposition(int n, double *A, double *W, double *V, int *info);
+    void eigen_decomposition(lapack_int n, double *A, double *W, double *V,
+                             lapack_int *info);
+    void eigen_workspace_query(lapack_int n, char jobvr, lapack_int *lwork,
+                               lapack_int *info);
+    void eigen_decomposition_ws(lapack_int n, double *A, lapack_int lda,
+                                char jobvr, double *wr, double *wi, double *V,
+                                lapack_int ldv, double *work, lapack_int lwork,
+                                lapack_int *info);
+    void symmetric_packed_eigen(lapack_int n, double *AP, char jobz, double *W,
+                                double *Z, lapack_int ldz, double *work,
+                                lapack_int *info);
+    void symmetric_workspace_query(lapack_int n, char jobz, lapack_int *lwork,
+                                   lapack_int *liwork, lapack_int *info);
+    void symmetric_eigen_decomposition(lapack_int n, double *A, lapack_int lda,
+                                       char jobz, double *W, double *Z,
+                                       lapack_int ldz, double *work,
+                                       lapack_int lwork, lapack_int *iwork,
+                                       lapack_int liwork, lapack_int *info);
+    void triangular_eigenvectors(lapack_int n, const double *T, lapack_int ldt,
+                                 char side, double *V, lapack_int ldv,
+                                 double *work, lapack_int *info);
+
+    void svd_workspace_query(lapack_int m, lapack_int n, char jobz,
+                             lapack_int *lwork, lapack_int *liwork,
+                             lapack_int *info);
+    void svd_decomposition(lapack_int m, lapack_int n, char jobz, double *A,
+                           lapack_int lda, double *S, double *U, lapack_int ldu,
+                           double *VT, lapack_int ldvt, double *work,
+                           lapack_int lwork, lapack_int *iwork,
+                           lapack_int *info);
+    void svd_subset_workspace_query(lapack_int m, lapack_int n, lapack_int il,
+                                    lapack_int iu, char jobv,
+                                    lapack_int *lwork, lapack_int *liwork,
+                                    lapack_int *info);
+    void svd_subset(lapack_int m, lapack_int n, lapack_int il, lapack_int iu,
+                    char jobv, double *A, lapack_int lda, lapack_int *ns,
+                    double *S, double *U, lapack_int ldu, double *VT,
+                    lapack_int ldvt, double *work, lapack_int lwork,
+                    lapack_int *iwork, lapack_int *info);
+
+    void hermitian_eigen_decomposition(lapack_int n, std::complex<double> *A,
+                                       lapack_int lda, char jobz, double *W,
+                                       lapack_int *info);
+    void hermitian_eigen_subset(lapack_int n, std::complex<double> *A,
+                                lapack_int lda, char jobz, lapack_int il,
+                                lapack_int iu, lapack_int *m, double *W,
+                                std::complex<double> *Z, lapack_int ldz,
+                                lapack_int *info);
 }
 
+namespace eigen_interface_detail
+{
+
+/**
+ * @brief The buffers handed to LAPACK by `eigen_decomposition`.
+ *
+ * All buffers are carved out of one block leased from
+ * `WorkspacePool::instance()` and returned to it when the workspace goes out
+ * of scope. The matrix buffer is 64-byte aligned and its leading dimension
+ * lda is padded to whole cache lines (and away from multiples of 4 KiB, which
+ * cause cache set conflicts between columns). work and iwork are large enough
+ * for every solver `solve_eigen` may pick: `dgeev`, `dsyevr` and `dtrevc`.
+ */
+struct EigenWorkspace
+{
+    WorkspaceLease lease;
+    double *a = nullptr;
+    lapack_int lda = 0;
+    double *wr = nullptr;
+    double *wi = nullptr;
+    double *work = nullptr;
+    lapack_int lwork = 0;
+    lapack_int *iwork = nullptr;
+    lapack_int liwork = 0;
+};
+
+/**
+ * @brief Lease a workspace for order n from the shared pool.
+ *
+ * @param n The order of the matrix.
+ * @param jobvr 'V' if eigenvectors will be computed, 'N' otherwise.
+ * @param with_matrix Whether the workspace includes the matrix buffer; if
+ * not, ws.a is null and the caller passes its own matrix to `dgeev`.
+ */
+EigenWorkspace lease_eigen_workspace(lapack_int n, char jobvr = 'V',
+                                     bool with_matrix = true);
+
+/**
+ * @brief The bytes `lease_eigen_workspace` takes from the pool for the same
+ * arguments, including the rounding up to the pool's size class.
+ */
+std::size_t eigen_workspace_bytes(lapack_int n, char jobvr = 'V',
+                                  bool with_matrix = true);
+
+/**
+ * @brief Eigenvalues and, for jobvr = 'V', eigenvectors of the n x n matrix
+ * at a (leading dimension lda, destroyed), in `dgeev`'s output format.
+ *
+ * A first goes through `analyze_structure`, and only a general matrix is
+ * handed to `dgeev`:
+ * - a diagonal matrix returns its diagonal and the unit vectors;
+ * - a triangular one returns its diagonal, in O(n) for jobvr = 'N', and
+ *   finds the eigenvectors by back substitution (`dtrevc`);
+ * - a symmetric one goes to `dsyevr`, ascending and with wi = 0; the
+ *   eigenvectors are written straight into v.
+ * The eigenvectors have unit length, as those of `dgeev`.
+ *
+ * @param ws The workspace of order n and job jobvr; only ws.work and
+ * ws.iwork are used.
+ * @return The structure of A that picked the solver.
+ * @throws std::invalid_argument if A holds NaN or Inf, std::runtime_error
+ * if LAPACK fails.
+ */
+StructureProfile solve_eigen(lapack_int n, double *a, lapack_int lda,
+                             char jobvr, double *wr, double *wi, double *v,
+                             lapack_int ldv, EigenWorkspace &ws);
+
+/**
+ * @brief `solve_eigen` for a matrix already analyzed by
+ * `analyze_structure`.
+ *
+ * It neither starts threads nor leases from the pool, so it is safe in a
+ * forked child process.
+ */
+void solve_analyzed_eigen(const StructureProfile &profile, lapack_int n,
+                          double *a, lapack_int lda, char jobvr, double *wr,
+                          double *wi, double *v, lapack_int ldv,
+                          EigenWorkspace &ws);
+
+/**
+ * @brief The lengths of ws.work (doubles) and ws.iwork (LAPACK integers)
+ * that `solve_eigen` needs for order n and job jobvr, for callers that
+ * own their buffers.
+ *
+ * @throws std::runtime_error if a LAPACK workspace query fails.
+ */
+void solve_eigen_workspace(lapack_int n, char jobvr, lapack_int *lwork,
+                           lapack_int *liwork);
+
+/**
+ * @brief Run `solve_eigen` on the matrix already stored in ws.a.
+ *
+ * @throws std::invalid_argument if A holds NaN or Inf, std::runtime_error
+ * if LAPACK fails.
+ */
+void run_eigen_decomposition(EigenWorkspace &ws, lapack_int n,
+                             Eigen::VectorXd &W, Eigen::MatrixXd &V);
+
+/**
+ * @brief Throws std::runtime_error naming the routine if info != 0.
+ */
+void check_lapack_info(const char *routine, lapack_int info);
+
+/**
+ * @brief Throws std::invalid_argument unless rows == cols.
+ */
+void check_square(Eigen::Index rows, Eigen::Index cols);
+
+/**
+ * @brief Throws std::invalid_argument if a rows x cols matrix has more
+ * elements than `lapack_int` can index.
+ */
+void check_lapack_size(Eigen::Index rows, Eigen::Index cols);
+
+/**
+ * @brief Whether `load_matrix` reads a Derived through the conversion
+ * kernels: plain double or float storage with unit inner stride.
+ */
+template <typename Derived>
+constexpr bool direct_layout =
+    (Derived::Flags & Eigen::DirectAccessBit) != 0 &&
+    Derived::InnerStrideAtCompileTime == 1 &&
+    (std::is_same<typename Derived::Scalar, double>::value ||
+     std::is_same<typename Derived::Scalar, float>::value);
+
+/**
+ * @brief Store A in the column-major buffer a with leading dimension lda.
+ *
+ * Plain double or float matrices, row- or column-major, go through the
+ * conversion kernels of layout_convert.h; anything else (expressions,
+ * strided blocks) is evaluated by Eigen straight into the buffer.
+ */
+template <typename Derived>
+void load_matrix(const Eigen::MatrixBase<Derived> &A, double *a,
+                 lapack_int lda)
+{
+    using Scalar = typename Derived::Scalar;
+    if constexpr (direct_layout<Derived>)
+    {
+        const Scalar *data = A.derived().data();
+        if (Derived::IsRowMajor)
+            transpose_matrix(data, A.outerStride(), A.rows(), A.cols(), a,
+                             lda);
+        else
+            copy_matrix(data, A.outerStride(), A.rows(), A.cols(), a, lda);
+    }
+    else
+    {
+        Eigen::Map<Eigen::MatrixXd, Eigen::Aligned16, Eigen::OuterStride<>>(
+            a, A.rows(), A.cols(), Eigen::OuterStride<>(lda))
+            .noalias() = A.template cast<double>();
+    }
+}
+
+} // namespace eigen_interface_detail
+
 /**
  * @brief Compute the eigenvalues and eigenvectors of a square matrix.
  *
  * This function uses the LAPACK library's `dgeev` function to perform
  * eigenvalue decomposition. It takes a square matrix as input and outputs the
- * eigenvalues and the corresponding eigenvectors. If computation fails, an
- * error code is returned.
+ * eigenvalues and the corresponding eigenvectors. If computation fails, a
+ * runtime_error exception is thrown.
+ *
+ * A can be any Eigen expression, e.g. `A0 + s * A1` or `X.transpose() * X`,
+ * in double or single precision and row- or column-major. It is evaluated
+ * exactly once, directly into the (padded, aligned) workspace that is
+ * passed to Fortran, so no temporary matrix and no extra copy are made.
+ *
+ * Diagonal, triangular and symmetric matrices are recognized and solved
+ * without `dgeev` (see `eigen_interface_detail::solve_eigen`).
  *
  * @param A The input matrix for eigenvalue decomposition.
  * @param W The vector that will store the computed eigenvalues.
  * @param V The matrix that will store the computed eigenvectors.
+ * @throws std::invalid_argument if A is not square or holds NaN or Inf.
+ */
+template <typename Derived>
+void eigen_decomposition(const Eigen::MatrixBase<Derived> &A,
+                         Eigen::VectorXd &W, Eigen::MatrixXd &V)
+{
+    eigen_interface_detail::check_square(A.rows(), A.cols());
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const auto n = static_cast<lapack_int>(A.rows());
+    auto ws = eigen_interface_detail::lease_eigen_workspace(n);
+    eigen_interface_detail::load_matrix(A, ws.a, ws.lda);
+    eigen_interface_detail::run_eigen_decomposition(ws, n, W, V);
+}
+
+/**
+ * @brief Compute the eigenvalues and eigenvectors of a square matrix
+ * straight into a file.
+ *
+ * The file is created in the framed format of matrix_io.h and holds an
+ * Eigenvalues frame (n x 2: real and imaginary parts) followed by an
+ * Eigenvectors frame (n x n, in the layout of `dgeev`). It is mapped into
+ * memory and `dgeev` writes W and V directly into the mapping, so V never
+ * exists in heap memory and is not copied or serialized afterwards: the
+ * peak heap use is the workspace with its copy of A, and the pages of V are
+ * written back (and can be evicted) by the kernel. For n = 20000 that saves
+ * the 3.2 GB of a heap V and a second pass over it.
+ *
+ * @param A The input matrix for eigenvalue decomposition.
+ * @param path The output file, replaced if it exists.
+ * @throws std::invalid_argument if A is not square, std::runtime_error if
+ * LAPACK fails or the file cannot be created, allocated or written.
+ */
+void eigen_decomposition_to_file(const Eigen::MatrixXd &A,
+                                 const std::string &path);
+
+/**
+ * @brief Pay the one-time start-up costs before the first real decomposition.
+ *
+ * The first decomposition in a process is several times slower than the
+ * following ones: it initializes the gfortran runtime, binds the LAPACK
+ * symbols, starts the BLAS thread team and page-faults its fresh workspace.
+ * `warmup` does all of that up front. It runs tiny dummy decompositions
+ * through `dgeev` and `dgesdd`, a matrix product that starts the BLAS
+ * threads, and prefaults one `eigen_decomposition` workspace of order max_n
+ * per expected calling thread in `WorkspacePool::instance()`.
+ *
+ * The size of the BLAS thread team is left as configured; use
+ * `set_blas_threads` from blas_threads.h to change it beforehand.
+ *
+ * @param max_n The largest matrix order that will be decomposed.
+ * @param threads The number of threads that will call `eigen_decomposition`
+ * concurrently, 0 for `default_thread_count()`.
+ * @return The number of workspaces prefaulted. It is less than threads if
+ * they do not fit under the pool's memory cap (see
+ * `WorkspacePool::prefault`); raise the cap first to warm them all.
+ * @throws std::invalid_argument if max_n < 1.
+ */
+unsigned warmup(int max_n, unsigned threads = 0);
+
+/**
+ * @brief Which singular vectors `svd_decomposition` should compute.
+ *
+ * `Full` gives the square U (m x m) and VT (n x n), `Thin` gives only the
+ * first min(m,n) columns of U and rows of VT, `ValuesOnly` skips the singular
+ * vectors altogether.
+ */
+enum class SvdMode
+{
+    Full,
+    Thin,
+    ValuesOnly
+};
+
+/**
+ * @brief Reusable workspace for the SVD routines.
+ *
+ * LAPACK's `dgesdd` and `dgesvdx` need a copy of the input matrix (it is
+ * destroyed) as well as real and integer workspaces whose size depends on the
+ * shape and the job. The context keeps those buffers alive between calls and
+ * only grows them, so repeated decompositions of the same shape perform no
+ * allocation and no further workspace queries. The real buffers are leased
+ * from `WorkspacePool::instance()`, so the memory of short-lived contexts is
+ * recycled rather than freed.
+ */
+class SvdContext
+{
+  public:
+    /**
+     * @brief Preallocate the buffers for decompositions of an m x n matrix.
+     *
+     * @param m Number of rows.
+     * @param n Number of columns.
+     * @param mode The job the buffers are sized for.
+     */
+    void reserve(lapack_int m, lapack_int n, SvdMode mode);
+
+    /**
+     * @brief Preallocate the buffers for `svd_subset` on an m x n matrix.
+     *
+     * @param m Number of rows.
+     * @param n Number of columns.
+     * @param k Number of leading singular values requested.
+     * @param compute_vectors Whether singular vectors are requested.
+     */
+    void reserve_subset(lapack_int m, lapack_int n, lapack_int k,
+                        bool compute_vectors);
+
+  private:
+    friend void svd_decomposition(const Eigen::MatrixXd &A, Eigen::VectorXd &S,
+                                  Eigen::MatrixXd &U, Eigen::MatrixXd &VT,
+                                  SvdMode mode, SvdContext &ctx);
+    friend void svd_subset(const Eigen::MatrixXd &A, int k, Eigen::VectorXd &S,
+                           Eigen::MatrixXd &U, Eigen::MatrixXd &VT,
+                           bool compute_vectors, SvdContext &ctx);
+
+    void grow(std::size_t a_size, std::size_t work_size);
+
+    WorkspaceLease buffer_; // the matrix copy, followed by the workspace
+    std::size_t a_size_ = 0;
+    std::size_t work_size_ = 0;
+    std::vector<lapack_int> iwork_;
+
+    // Shape and job of the last workspace query, to skip repeated queries.
+    lapack_int query_m_ = -1;
+    lapack_int query_n_ = -1;
+    lapack_int query_k_ = -1;
+    char query_job_ = 0;
+};
+
+/**
+ * @brief Compute the singular value decomposition A = U * diag(S) * VT.
+ *
+ * This function uses LAPACK's divide-and-conquer `dgesdd`, which is
+ * considerably faster than `Eigen::JacobiSVD` for all but tiny matrices. The
+ * singular values are returned in descending order. Note that the right
+ * singular vectors are returned transposed, exactly as LAPACK produces them.
+ *
+ * @param A The input matrix (m x n).
+ * @param S The vector that will store the min(m,n) singular values.
+ * @param U The matrix that will store the left singular vectors (untouched
+ * for `SvdMode::ValuesOnly`).
+ * @param VT The matrix that will store the transposed right singular vectors
+ * (untouched for `SvdMode::ValuesOnly`).
+ * @param mode Which singular vectors to compute.
+ * @param ctx The workspace to reuse.
+ */
+void svd_decomposition(const Eigen::MatrixXd &A, Eigen::VectorXd &S,
+                       Eigen::MatrixXd &U, Eigen::MatrixXd &VT, SvdMode mode,
+                       SvdContext &ctx);
+
+/**
+ * @brief Compute the singular value decomposition using a per-thread
+ * workspace.
+ *
+ * @see svd_decomposition(const Eigen::MatrixXd &, Eigen::VectorXd &,
+ * Eigen::MatrixXd &, Eigen::MatrixXd &, SvdMode, SvdContext &)
+ */
+void svd_decomposition(const Eigen::MatrixXd &A, Eigen::VectorXd &S,
+                       Eigen::MatrixXd &U, Eigen::MatrixXd &VT,
+                       SvdMode mode = SvdMode::Thin);
+
+/**
+ * @brief Compute only the singular values of a matrix.
+ *
+ * @param A The input matrix.
+ * @param S The vector that will store the singular values, descending.
+ */
+void singular_values(const Eigen::MatrixXd &A, Eigen::VectorXd &S);
+
+/**
+ * @brief Compute the k largest singular values and (optionally) vectors.
+ *
+ * This function uses LAPACK's `dgesvdx`, which only computes the requested
+ * part of the spectrum. It is the method of choice for low-rank
+ * approximations, where A is approximated by U * diag(S) * VT.
+ *
+ * @param A The input matrix (m x n).
+ * @param k The number of leading singular triplets, 1 <= k <= min(m,n).
+ * @param S The vector that will store the k singular values, descending.
+ * @param U The matrix that will store the m x k left singular vectors.
+ * @param VT The matrix that will store the k x n transposed right singular
+ * vectors.
+ * @param compute_vectors Whether U and VT are computed.
+ * @param ctx The workspace to reuse.
+ */
+void svd_subset(const Eigen::MatrixXd &A, int k, Eigen::VectorXd &S,
+                Eigen::MatrixXd &U, Eigen::MatrixXd &VT, bool compute_vectors,
+                SvdContext &ctx);
+
+/**
+ * @brief Compute the singular value decompositions of a batch of matrices.
+ *
+ * All matrices are decomposed through a single workspace, so a batch of
+ * equally shaped matrices costs exactly one workspace allocation.
+ *
+ * @param As The input matrices.
+ * @param S The singular values of each matrix (resized to As.size()).
+ * @param U The left singular vectors of each matrix (resized to As.size()).
+ * @param VT The transposed right singular vectors of each matrix (resized to
+ * As.size()).
+ * @param mode Which singular vectors to compute.
+ */
+void svd_decomposition_batched(const std::vector<Eigen::MatrixXd> &As,
+                               std::vector<Eigen::VectorXd> &S,
+                               std::vector<Eigen::MatrixXd> &U,
+                               std::vector<Eigen::MatrixXd> &VT,
+                               SvdMode mode = SvdMode::Thin);
+
+/**
+ * @brief Compute the eigenvalues and eigenvectors of a complex Hermitian
+ * matrix.
+ *
+ * This function uses LAPACK's `zheevd`. Eigen stores `std::complex<double>`
+ * interleaved, which is exactly Fortran's `complex(c_double_complex)` layout,
+ * so the data is handed to LAPACK as is. The only copy is A into V, which
+ * LAPACK then overwrites with the eigenvectors. Only the lower triangle of A
+ * is referenced.
+ *
+ * @param A The Hermitian input matrix.
+ * @param W The vector that will store the real eigenvalues, ascending.
+ * @param V The matrix that will store the orthonormal eigenvectors.
+ * @throws std::invalid_argument if A is not square, std::runtime_error if
+ * LAPACK fails.
+ */
+void hermitian_eigen_decomposition(const Eigen::MatrixXcd &A,
+                                   Eigen::VectorXd &W, Eigen::MatrixXcd &V);
+
+/**
+ * @brief Compute the eigen decomposition of a Hermitian matrix in place.
+ *
+ * Same as `hermitian_eigen_decomposition`, but A is overwritten with the
+ * eigenvectors, so no copy of the matrix is made at all.
+ *
+ * @param A The Hermitian input matrix, on output the eigenvectors.
+ * @param W The vector that will store the real eigenvalues, ascending.
+ * @throws std::invalid_argument if A is not square, std::runtime_error if
+ * LAPACK fails.
+ */
+void hermitian_eigen_decomposition_inplace(Eigen::MatrixXcd &A,
+                                           Eigen::VectorXd &W);
+
+/**
+ * @brief Compute only the eigenvalues of a complex Hermitian matrix.
+ *
+ * @param A The Hermitian input matrix.
+ * @param W The vector that will store the real eigenvalues, ascending.
+ * @throws std::invalid_argument if A is not square, std::runtime_error if
+ * LAPACK fails.
+ */
+void hermitian_eigenvalues(const Eigen::MatrixXcd &A, Eigen::VectorXd &W);
+
+/**
+ * @brief Compute the eigenvalues il..iu of a complex Hermitian matrix.
+ *
+ * This function uses LAPACK's `zheevr`, which only computes the requested
+ * part of the spectrum. Indices are 0-based and inclusive, counted in
+ * ascending order of the eigenvalues.
+ *
+ * @param A The Hermitian input matrix.
+ * @param il Index of the smallest eigenvalue wanted.
+ * @param iu Index of the largest eigenvalue wanted.
+ * @param W The vector that will store the iu-il+1 eigenvalues, ascending.
+ * @param V The matrix that will store the corresponding eigenvectors.
+ * @param compute_vectors Whether V is computed.
+ * @throws std::invalid_argument if A is not square or the index range is
+ * out of range, std::runtime_error if LAPACK fails.
  */
-void eigen_decomposition(const Eigen::MatrixXd &A, Eigen::VectorXd &W,
-                         Eigen::MatrixXd &V);
+void hermitian_eigen_subset(const Eigen::MatrixXcd &A, int il, int iu,
+                            Eigen::VectorXd &W, Eigen::MatrixXcd &V,
+                            bool compute_vectors = true);
 
 #endif // EIGEN_INTERFACE_H
\ No newline at end of file
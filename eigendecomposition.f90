@@ -3,9 +3,32 @@
 !> @date 07.07.2024
 !> @brief This Fortran module performs the eigen decomposition.
 
+! The file is preprocessed (-cpp). Defining ILP64 selects 64-bit LAPACK
+! integers; LAPACK_SUFFIX64 additionally maps the LAPACK routines to the
+! 64_-suffixed symbols of reference LAPACK and OpenBLAS ILP64 builds.
+#ifdef LAPACK_SUFFIX64
+#define dgeev dgeev_64
+#define dgesdd dgesdd_64
+#define dgesvdx dgesvdx_64
+#define zheevd zheevd_64
+#define zheevr zheevr_64
+#define dspev dspev_64
+#define dsyevr dsyevr_64
+#define dtrevc dtrevc_64
+#endif
+
 module eigendecomposition_module
     use iso_c_binding
     implicit none
+
+    !> Kind of all integers exchanged with LAPACK (sizes, workspace lengths,
+    !> info codes); 64-bit in ILP64 builds so that n*n and large workspace
+    !> lengths do not overflow.
+#ifdef ILP64
+    integer, parameter :: lapack_int = c_int64_t
+#else
+    integer, parameter :: lapack_int = c_int
+#endif
 contains
     !>  @brief This subroutine performs the eigen decomposition of a given matrix.
     !>  It is a binding to LAPACK's `dgeev` function for eigen decomposition.
@@ -20,13 +43,13 @@ contains
     !> @param[out] V output matrix (allocated on input) to store the eigenvectors
     !> @param[out] info output status: if 0 then successful exit
     subroutine eigen_decomposition(n, A, W, V, info) bind(C)
-        integer(c_int), value :: n
+        integer(lapack_int), value :: n
         real(c_double), intent(inout) :: A(n, n)
         real(c_double), intent(out) :: W(n)
         real(c_double), intent(out) :: V(n, n)
-        integer(c_int), intent(out) :: info
+        integer(lapack_int), intent(out) :: info
 
-        integer(c_int) :: lwork, lda
+        integer(lapack_int) :: lwork, lda
         real(c_double), allocatable :: work(:)
         character(len=1) :: jobvl, jobvr
         real(c_double), allocatable :: wr(:)
@@ -34,7 +57,7 @@ contains
         real(c_double), allocatable :: vl(:,:)
 
         lda = n
-        lwork = max(1, 4*n)
+        lwork = max(1_lapack_int, 4*n)
         allocate(work(lwork))
         allocate(wr(n))
         allocate(wi(n))
@@ -54,4 +77,432 @@ contains
         deallocate(wi)
         deallocate(vl)
     end subroutine eigen_decomposition
+
+    !>  @brief Workspace query for `eigen_decomposition_ws`.
+    !>  Asks LAPACK's `dgeev` for the optimal workspace length, so that the
+    !>  caller can allocate the workspace once and reuse it across calls.
+    !>
+    !> @param[in] n the order of the matrix
+    !> @param[in] jobvr 'V' to compute eigenvectors, 'N' for eigenvalues only
+    !> @param[out] lwork optimal length of the workspace
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine eigen_workspace_query(n, jobvr, lwork, info) bind(C)
+        integer(lapack_int), value :: n
+        character(kind=c_char), value :: jobvr
+        integer(lapack_int), intent(out) :: lwork, info
+
+        real(c_double) :: A(1, 1), wr(1), wi(1), vl(1, 1), V(1, 1), work(1)
+
+        call dgeev('N', jobvr, n, A, max(1_lapack_int, n), wr, wi, vl, 1_lapack_int, &
+                   V, max(1_lapack_int, n), work, -1_lapack_int, info)
+        lwork = max(1_lapack_int, int(work(1), lapack_int))
+    end subroutine eigen_workspace_query
+
+    !>  @brief Eigen decomposition with a caller-owned workspace.
+    !>  Same as `eigen_decomposition`, but nothing is allocated: the workspace
+    !>  comes from the caller (see `eigen_workspace_query`), the real and
+    !>  imaginary parts of the eigenvalues are both returned, and A may have a
+    !>  leading dimension larger than n.
+    !>
+    !> @param[in] n the order of the given matrix
+    !> @param[inout] A input matrix of dimensions (lda,n), on output it gets overwritten
+    !> @param[in] lda leading dimension of A
+    !> @param[in] jobvr 'V' to compute eigenvectors, 'N' for eigenvalues only
+    !> @param[out] wr real parts of the eigenvalues
+    !> @param[out] wi imaginary parts of the eigenvalues
+    !> @param[out] V output matrix of dimensions (ldv,n) for the eigenvectors
+    !> @param[in] ldv leading dimension of V
+    !> @param[inout] work workspace of length lwork
+    !> @param[in] lwork length of work
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine eigen_decomposition_ws(n, A, lda, jobvr, wr, wi, V, ldv, work, lwork, info) bind(C)
+        integer(lapack_int), value :: n, lda, ldv, lwork
+        real(c_double), intent(inout) :: A(lda, *)
+        character(kind=c_char), value :: jobvr
+        real(c_double), intent(out) :: wr(*), wi(*)
+        real(c_double), intent(out) :: V(ldv, *)
+        real(c_double), intent(inout) :: work(*)
+        integer(lapack_int), intent(out) :: info
+
+        real(c_double) :: vl(1, 1)
+
+        call dgeev('N', jobvr, n, A, lda, wr, wi, vl, 1_lapack_int, V, ldv, work, lwork, info)
+    end subroutine eigen_decomposition_ws
+
+    !>  @brief Eigen decomposition of a real symmetric matrix in packed storage.
+    !>  It is a binding to LAPACK's `dspev` function, see
+    !>  <a href="https://netlib.org/lapack/explore-html/d8/d1c/group__hpev.html">
+    !>  LAPACK's `dspev` function documentation
+    !>  </a>.
+    !>  Only the lower triangle is stored, column by column, so the working
+    !>  copy of the matrix takes n*(n+1)/2 instead of n*n entries.
+    !>
+    !> @param[in] n the order of the matrix
+    !> @param[inout] AP the packed lower triangle, destroyed on output
+    !> @param[in] jobz 'V' to compute eigenvectors, 'N' for eigenvalues only
+    !> @param[out] W output vector of the n eigenvalues, ascending
+    !> @param[out] Z the orthonormal eigenvectors (not referenced if jobz = 'N')
+    !> @param[in] ldz leading dimension of Z
+    !> @param[inout] work workspace of length 3*n
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine symmetric_packed_eigen(n, AP, jobz, W, Z, ldz, work, info) bind(C)
+        integer(lapack_int), value :: n, ldz
+        real(c_double), intent(inout) :: AP(*)
+        character(kind=c_char), value :: jobz
+        real(c_double), intent(out) :: W(*)
+        real(c_double), intent(out) :: Z(ldz, *)
+        real(c_double), intent(inout) :: work(*)
+        integer(lapack_int), intent(out) :: info
+
+        call dspev(jobz, 'L', n, AP, W, Z, ldz, work, info)
+    end subroutine symmetric_packed_eigen
+
+    !>  @brief Workspace query for `symmetric_eigen_decomposition`.
+    !>  Asks LAPACK's `dsyevr` for the optimal size of the real and integer
+    !>  workspaces, so that the caller can lease them with the rest of its
+    !>  buffers. Both are O(n), with or without eigenvectors.
+    !>
+    !> @param[in] n the order of the matrix
+    !> @param[in] jobz 'V' if eigenvectors will be computed, 'N' otherwise
+    !> @param[out] lwork the optimal length of the real workspace
+    !> @param[out] liwork the length of the integer workspace, including the
+    !>  2*n entries of the eigenvector supports
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine symmetric_workspace_query(n, jobz, lwork, liwork, info) bind(C)
+        integer(lapack_int), value :: n
+        character(kind=c_char), value :: jobz
+        integer(lapack_int), intent(out) :: lwork, liwork, info
+
+        real(c_double) :: a(1, 1), w(1), z(1, 1), work_query(1)
+        integer(lapack_int) :: m, isuppz(2), iwork_query(1)
+
+        call dsyevr(jobz, 'A', 'L', n, a, max(1_lapack_int, n), 0.0_c_double, &
+                    0.0_c_double, 0_lapack_int, 0_lapack_int, 0.0_c_double, m, w, &
+                    z, max(1_lapack_int, n), isuppz, work_query, -1_lapack_int, &
+                    iwork_query, -1_lapack_int, info)
+        lwork = max(1_lapack_int, int(work_query(1), lapack_int))
+        liwork = max(1_lapack_int, iwork_query(1)) + 2*max(1_lapack_int, n)
+    end subroutine symmetric_workspace_query
+
+    !>  @brief Eigen decomposition of a real symmetric matrix with a
+    !>  caller-owned workspace.
+    !>  It is a binding to LAPACK's `dsyevr` function (relatively robust
+    !>  representations), see
+    !>  <a href="https://netlib.org/lapack/explore-html/d1/d56/group__heevr.html">
+    !>  LAPACK's `dsyevr` function documentation
+    !>  </a>.
+    !>  Unlike `dsyevd`, whose workspace for eigenvectors is 2*n*n, it needs
+    !>  O(n) workspace and writes the eigenvectors into a separate Z.
+    !>
+    !> @param[in] n the order of the given matrix
+    !> @param[inout] A symmetric matrix of dimensions (lda,n), only the lower
+    !>  triangle is referenced; destroyed on output
+    !> @param[in] lda leading dimension of A
+    !> @param[in] jobz 'V' to compute eigenvectors, 'N' for eigenvalues only
+    !> @param[out] W output vector of the eigenvalues in ascending order
+    !> @param[out] Z the orthonormal eigenvectors (not referenced if jobz = 'N')
+    !> @param[in] ldz leading dimension of Z
+    !> @param[inout] work workspace of length lwork
+    !> @param[in] lwork length of work, see `symmetric_workspace_query`
+    !> @param[inout] iwork integer workspace of length liwork
+    !> @param[in] liwork length of iwork, see `symmetric_workspace_query`
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine symmetric_eigen_decomposition(n, A, lda, jobz, W, Z, ldz, work, lwork, &
+                                             iwork, liwork, info) bind(C)
+        integer(lapack_int), value :: n, lda, ldz, lwork, liwork
+        real(c_double), intent(inout) :: A(lda, *)
+        character(kind=c_char), value :: jobz
+        real(c_double), intent(out) :: W(*)
+        real(c_double), intent(out) :: Z(ldz, *)
+        real(c_double), intent(inout) :: work(*)
+        integer(lapack_int), intent(inout) :: iwork(*)
+        integer(lapack_int), intent(out) :: info
+
+        integer(lapack_int) :: m, supports
+
+        ! The first 2*n entries of iwork hold the eigenvector supports
+        supports = 2*max(1_lapack_int, n)
+        call dsyevr(jobz, 'A', 'L', n, A, lda, 0.0_c_double, 0.0_c_double, &
+                    0_lapack_int, 0_lapack_int, 0.0_c_double, m, W, Z, ldz, &
+                    iwork, work, lwork, iwork(supports + 1), liwork - supports, info)
+    end subroutine symmetric_eigen_decomposition
+
+    !>  @brief Eigenvectors of a real upper triangular matrix.
+    !>  It is a binding to LAPACK's `dtrevc` function, see
+    !>  <a href="https://netlib.org/lapack/explore-html/d4/d54/group__trevc.html">
+    !>  LAPACK's `dtrevc` function documentation
+    !>  </a>.
+    !>  The eigenvalues of T are its diagonal; the vectors are found by back
+    !>  substitution, each scaled so that its largest component has magnitude 1.
+    !>
+    !> @param[in] n the order of the matrix
+    !> @param[in] T upper triangular matrix of dimensions (ldt,n)
+    !> @param[in] ldt leading dimension of T
+    !> @param[in] side 'R' for the right eigenvectors of T, 'L' for the left
+    !>  ones (the right eigenvectors of T transposed)
+    !> @param[out] V output matrix of dimensions (ldv,n) for the eigenvectors
+    !> @param[in] ldv leading dimension of V
+    !> @param[inout] work workspace of length 3*n
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine triangular_eigenvectors(n, T, ldt, side, V, ldv, work, info) bind(C)
+        integer(lapack_int), value :: n, ldt, ldv
+        real(c_double), intent(in) :: T(ldt, *)
+        character(kind=c_char), value :: side
+        real(c_double), intent(out) :: V(ldv, *)
+        real(c_double), intent(inout) :: work(*)
+        integer(lapack_int), intent(out) :: info
+
+        logical :: select(1)
+        real(c_double) :: unused(1, 1)
+        integer(lapack_int) :: m
+
+        if (side == 'L') then
+            call dtrevc('L', 'A', select, n, T, ldt, V, ldv, unused, 1_lapack_int, &
+                        n, m, work, info)
+        else
+            call dtrevc('R', 'A', select, n, T, ldt, unused, 1_lapack_int, V, ldv, &
+                        n, m, work, info)
+        end if
+    end subroutine triangular_eigenvectors
+
+    !>  @brief Workspace query for `svd_decomposition`.
+    !>  Asks LAPACK's `dgesdd` for the optimal size of the real and integer
+    !>  workspaces so that the caller can allocate them once and reuse them
+    !>  across calls of the same shape.
+    !>
+    !> @param[in] m number of rows of the matrix
+    !> @param[in] n number of columns of the matrix
+    !> @param[in] jobz 'A' for full U/VT, 'S' for thin U/VT, 'N' for values only
+    !> @param[out] lwork optimal length of the real workspace
+    !> @param[out] liwork required length of the integer workspace
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine svd_workspace_query(m, n, jobz, lwork, liwork, info) bind(C)
+        integer(lapack_int), value :: m, n
+        character(kind=c_char), value :: jobz
+        integer(lapack_int), intent(out) :: lwork, liwork, info
+
+        real(c_double) :: A(1, 1), S(1), U(1, 1), VT(1, 1), work(1)
+        integer(lapack_int) :: iwork(1)
+
+        call dgesdd(jobz, m, n, A, max(1_lapack_int, m), S, U, max(1_lapack_int, m), &
+                    VT, max(1_lapack_int, n), work, -1_lapack_int, iwork, info)
+        lwork = max(1_lapack_int, int(work(1), lapack_int))
+        liwork = max(1_lapack_int, 8*min(m, n))
+    end subroutine svd_workspace_query
+
+    !>  @brief This subroutine performs the singular value decomposition of a
+    !>  given matrix. It is a binding to LAPACK's divide-and-conquer `dgesdd`
+    !>  function, see
+    !>  <a href="https://netlib.org/lapack/explore-html/d1/d7e/group__gesdd.html">
+    !>  LAPACK's `dgesdd` function documentation
+    !>  </a>.
+    !>  The workspaces are owned by the caller (see `svd_workspace_query`).
+    !>
+    !> @param[in] m number of rows of the matrix
+    !> @param[in] n number of columns of the matrix
+    !> @param[in] jobz 'A' for full U/VT, 'S' for thin U/VT, 'N' for values only
+    !> @param[inout] A input matrix of dimensions (lda,n), destroyed on output
+    !> @param[in] lda leading dimension of A
+    !> @param[out] S output vector of the min(m,n) singular values, descending
+    !> @param[out] U left singular vectors (not referenced if jobz = 'N')
+    !> @param[in] ldu leading dimension of U
+    !> @param[out] VT transposed right singular vectors (not referenced if jobz = 'N')
+    !> @param[in] ldvt leading dimension of VT
+    !> @param[inout] work real workspace of length lwork
+    !> @param[in] lwork length of work
+    !> @param[inout] iwork integer workspace of length 8*min(m,n)
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine svd_decomposition(m, n, jobz, A, lda, S, U, ldu, VT, ldvt, &
+                                 work, lwork, iwork, info) bind(C)
+        integer(lapack_int), value :: m, n, lda, ldu, ldvt, lwork
+        character(kind=c_char), value :: jobz
+        real(c_double), intent(inout) :: A(lda, *)
+        real(c_double), intent(out) :: S(*)
+        real(c_double), intent(out) :: U(ldu, *)
+        real(c_double), intent(out) :: VT(ldvt, *)
+        real(c_double), intent(inout) :: work(*)
+        integer(lapack_int), intent(inout) :: iwork(*)
+        integer(lapack_int), intent(out) :: info
+
+        call dgesdd(jobz, m, n, A, lda, S, U, ldu, VT, ldvt, work, lwork, iwork, info)
+    end subroutine svd_decomposition
+
+    !>  @brief Workspace query for `svd_subset`.
+    !>
+    !> @param[in] m number of rows of the matrix
+    !> @param[in] n number of columns of the matrix
+    !> @param[in] il index of the largest singular value wanted (1-based)
+    !> @param[in] iu index of the smallest singular value wanted (1-based)
+    !> @param[in] jobv 'V' to compute singular vectors, 'N' for values only
+    !> @param[out] lwork optimal length of the real workspace
+    !> @param[out] liwork required length of the integer workspace
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine svd_subset_workspace_query(m, n, il, iu, jobv, lwork, liwork, info) bind(C)
+        integer(lapack_int), value :: m, n, il, iu
+        character(kind=c_char), value :: jobv
+        integer(lapack_int), intent(out) :: lwork, liwork, info
+
+        real(c_double) :: A(1, 1), S(1), U(1, 1), VT(1, 1), work(1)
+        integer(lapack_int) :: iwork(1), ns
+
+        call dgesvdx(jobv, jobv, 'I', m, n, A, max(1_lapack_int, m), 0.0_c_double, 0.0_c_double, &
+                     il, iu, ns, S, U, max(1_lapack_int, m), VT, max(1_lapack_int, iu - il + 1), &
+                     work, -1_lapack_int, iwork, info)
+        lwork = max(1_lapack_int, int(work(1), lapack_int))
+        liwork = max(1_lapack_int, 12*min(m, n))
+    end subroutine svd_subset_workspace_query
+
+    !>  @brief Computes the singular values il..iu (in descending order) and,
+    !>  optionally, the corresponding singular vectors. It is a binding to
+    !>  LAPACK's `dgesvdx` function, see
+    !>  <a href="https://netlib.org/lapack/explore-html/d4/d70/group__gesvdx.html">
+    !>  LAPACK's `dgesvdx` function documentation
+    !>  </a>.
+    !>
+    !> @param[in] m number of rows of the matrix
+    !> @param[in] n number of columns of the matrix
+    !> @param[in] il index of the largest singular value wanted (1-based)
+    !> @param[in] iu index of the smallest singular value wanted (1-based)
+    !> @param[in] jobv 'V' to compute singular vectors, 'N' for values only
+    !> @param[inout] A input matrix of dimensions (lda,n), destroyed on output
+    !> @param[in] lda leading dimension of A
+    !> @param[out] ns number of singular values found
+    !> @param[out] S output vector of the singular values
+    !> @param[out] U left singular vectors, dimensions (ldu, iu-il+1)
+    !> @param[in] ldu leading dimension of U
+    !> @param[out] VT transposed right singular vectors, dimensions (ldvt, n)
+    !> @param[in] ldvt leading dimension of VT
+    !> @param[inout] work real workspace of length lwork
+    !> @param[in] lwork length of work
+    !> @param[inout] iwork integer workspace of length 12*min(m,n)
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine svd_subset(m, n, il, iu, jobv, A, lda, ns, S, U, ldu, VT, ldvt, &
+                          work, lwork, iwork, info) bind(C)
+        integer(lapack_int), value :: m, n, il, iu, lda, ldu, ldvt, lwork
+        character(kind=c_char), value :: jobv
+        real(c_double), intent(inout) :: A(lda, *)
+        integer(lapack_int), intent(out) :: ns
+        real(c_double), intent(out) :: S(*)
+        real(c_double), intent(out) :: U(ldu, *)
+        real(c_double), intent(out) :: VT(ldvt, *)
+        real(c_double), intent(inout) :: work(*)
+        integer(lapack_int), intent(inout) :: iwork(*)
+        integer(lapack_int), intent(out) :: info
+
+        call dgesvdx(jobv, jobv, 'I', m, n, A, lda, 0.0_c_double, 0.0_c_double, &
+                     il, iu, ns, S, U, ldu, VT, ldvt, work, lwork, iwork, info)
+    end subroutine svd_subset
+
+    !>  @brief This subroutine computes the eigenvalues and, optionally, the
+    !>  eigenvectors of a complex Hermitian matrix.
+    !>  It is a binding to LAPACK's divide-and-conquer `zheevd` function, see
+    !>  <a href="https://netlib.org/lapack/explore-html/d9/de3/group__heevd.html">
+    !>  LAPACK's `zheevd` function documentation
+    !>  </a>.
+    !>  The matrix is passed in its native interleaved complex storage, and on
+    !>  exit with jobz = 'V' it holds the orthonormal eigenvectors, so no
+    !>  separate output matrix is needed.
+    !>
+    !> @param[in] n the order of the given matrix
+    !> @param[inout] A Hermitian matrix of dimensions (lda,n), only the lower
+    !>  triangle is referenced; on output the eigenvectors (jobz = 'V') or destroyed
+    !> @param[in] lda leading dimension of A
+    !> @param[in] jobz 'V' to compute eigenvectors, 'N' for eigenvalues only
+    !> @param[out] W output vector of the eigenvalues in ascending order
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine hermitian_eigen_decomposition(n, A, lda, jobz, W, info) bind(C)
+        integer(lapack_int), value :: n, lda
+        complex(c_double_complex), intent(inout) :: A(lda, *)
+        character(kind=c_char), value :: jobz
+        real(c_double), intent(out) :: W(*)
+        integer(lapack_int), intent(out) :: info
+
+        integer(lapack_int) :: lwork, lrwork, liwork
+        complex(c_double_complex) :: work_query(1)
+        real(c_double) :: rwork_query(1)
+        integer(lapack_int) :: iwork_query(1)
+        complex(c_double_complex), allocatable :: work(:)
+        real(c_double), allocatable :: rwork(:)
+        integer(lapack_int), allocatable :: iwork(:)
+
+        call zheevd(jobz, 'L', n, A, lda, W, work_query, -1_lapack_int, rwork_query, -1_lapack_int, &
+                    iwork_query, -1_lapack_int, info)
+        if (info /= 0) return
+        lwork = max(1_lapack_int, int(real(work_query(1)), lapack_int))
+        lrwork = max(1_lapack_int, int(rwork_query(1), lapack_int))
+        liwork = max(1_lapack_int, iwork_query(1))
+        allocate(work(lwork))
+        allocate(rwork(lrwork))
+        allocate(iwork(liwork))
+
+        call zheevd(jobz, 'L', n, A, lda, W, work, lwork, rwork, lrwork, &
+                    iwork, liwork, info)
+
+        deallocate(work)
+        deallocate(rwork)
+        deallocate(iwork)
+    end subroutine hermitian_eigen_decomposition
+
+    !>  @brief This subroutine computes the eigenvalues il..iu (in ascending
+    !>  order) and, optionally, the eigenvectors of a complex Hermitian matrix.
+    !>  It is a binding to LAPACK's MRRR based `zheevr` function, see
+    !>  <a href="https://netlib.org/lapack/explore-html/d9/dd2/group__heevr.html">
+    !>  LAPACK's `zheevr` function documentation
+    !>  </a>.
+    !>
+    !> @param[in] n the order of the given matrix
+    !> @param[inout] A Hermitian matrix of dimensions (lda,n), only the lower
+    !>  triangle is referenced; destroyed on output
+    !> @param[in] lda leading dimension of A
+    !> @param[in] jobz 'V' to compute eigenvectors, 'N' for eigenvalues only
+    !> @param[in] il index of the smallest eigenvalue wanted (1-based)
+    !> @param[in] iu index of the largest eigenvalue wanted (1-based)
+    !> @param[out] m number of eigenvalues found
+    !> @param[out] W output vector (length n) whose first m entries are the eigenvalues
+    !> @param[out] Z output matrix of dimensions (ldz, iu-il+1) for the eigenvectors
+    !> @param[in] ldz leading dimension of Z
+    !> @param[out] info output status: if 0 then successful exit
+    subroutine hermitian_eigen_subset(n, A, lda, jobz, il, iu, m, W, Z, ldz, info) bind(C)
+        integer(lapack_int), value :: n, lda, il, iu, ldz
+        complex(c_double_complex), intent(inout) :: A(lda, *)
+        character(kind=c_char), value :: jobz
+        integer(lapack_int), intent(out) :: m
+        real(c_double), intent(out) :: W(*)
+        complex(c_double_complex), intent(out) :: Z(ldz, *)
+        integer(lapack_int), intent(out) :: info
+
+        integer(lapack_int) :: lwork, lrwork, liwork
+        complex(c_double_complex) :: work_query(1)
+        real(c_double) :: rwork_query(1)
+        integer(lapack_int) :: iwork_query(1)
+        complex(c_double_complex), allocatable :: work(:)
+        real(c_double), allocatable :: rwork(:)
+        integer(lapack_int), allocatable :: iwork(:)
+        integer(lapack_int), allocatable :: isuppz(:)
+
+        allocate(isuppz(2*max(1_lapack_int, iu - il + 1)))
+
+        call zheevr(jobz, 'I', 'L', n, A, lda, 0.0_c_double, 0.0_c_double, il, iu, &
+                    0.0_c_double, m, W, Z, ldz, isuppz, work_query, -1_lapack_int, &
+                    rwork_query, -1_lapack_int, iwork_query, -1_lapack_int, info)
+        if (info /= 0) then
+            deallocate(isuppz)
+            return
+        end if
+        lwork = max(1_lapack_int, int(real(work_query(1)), lapack_int))
+        lrwork = max(1_lapack_int, int(rwork_query(1), lapack_int))
+        liwork = max(1_lapack_int, iwork_query(1))
+        allocate(work(lwork))
+        allocate(rwork(lrwork))
+        allocate(iwork(liwork))
+
+        call zheevr(jobz, 'I', 'L', n, A, lda, 0.0_c_double, 0.0_c_double, il, iu, &
+                    0.0_c_double, m, W, Z, ldz, isuppz, work, lwork, &
+                    rwork, lrwork, iwork, liwork, info)
+
+        deallocate(work)
+        deallocate(rwork)
+        deallocate(iwork)
+        deallocate(isuppz)
+    end subroutine hermitian_eigen_subset
 end module eigendecomposition_module
@@ -0,0 +1,696 @@
+/**
+ * @file eigsolve.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief A filter that decomposes a stream of matrices, for use in shell
+ * pipelines such as `producer | eigsolve --binary | consumer`.
+ *
+ * eigsolve reads Matrix frames (see matrix_io.h) from stdin until it ends
+ * and answers each n x n matrix, in order, with an Eigenvalues frame
+ * (n x 2: real and imaginary parts) followed, unless `--values-only` is
+ * given, by an Eigenvectors frame (n x n, as returned by `dgeev`: for a
+ * complex pair, columns j and j+1 hold the real and imaginary parts of the
+ * first vector).
+ *
+ * A reader thread fills two input buffers in turn, so the next matrix is
+ * read while the current one is decomposed. `dgeev` runs directly on the
+ * input buffer and writes its eigenvalues and eigenvectors straight into
+ * the output message, frame headers included, so nothing is copied after
+ * the decomposition. When stdout is a pipe, large messages are handed to it
+ * with vmsplice() instead of being copied by write(). Input still goes
+ * through read(): there is no way to splice from a pipe into user memory
+ * without a copy.
+ *
+ * With `--input` and `--output`, eigsolve works as a batch driver on a
+ * file of Matrix frames instead: the answers go to the output file in the
+ * same order. The file I/O runs on an `IoEngine` (see io_engine.h; io_uring
+ * where available) with depth registered input and output buffers, so the
+ * next matrices are read and the previous answers written while LAPACK
+ * computes. `--direct` reads the input with O_DIRECT into page-aligned
+ * buffers, bypassing the page cache; the output is written through the page
+ * cache, whose write-back overlaps the compute anyway. `--mmap-output`
+ * instead creates the output file at its final size, maps it, and has
+ * `dgeev` write each answer straight into the mapping: there are no output
+ * buffers and no writes, and answers larger than RAM are paged out by the
+ * kernel as they are produced.
+ *
+ * Usage: eigsolve --binary [--values-only]
+ *                 [--input=FILE --output=FILE [--io=auto|uring|sync]
+ *                  [--direct] [--depth=N] [--mmap-output]]
+ */
+
+#include "eigen_interface.h"
+#include "io_engine.h"
+#include "matrix_io.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+namespace
+{
+
+/**
+ * @brief Output messages from this size on are spliced into a pipe.
+ */
+constexpr std::size_t splice_threshold = 1 << 16;
+
+struct InputSlot
+{
+    FrameHeader header;
+    std::vector<double> data;
+    bool full = false;
+};
+
+/**
+ * @brief Reads frames on a background thread into two alternating slots.
+ */
+class FrameReader
+{
+  public:
+    explicit FrameReader(int fd) : state_(std::make_shared<State>())
+    {
+        thread_ = std::thread(run, fd, state_);
+    }
+
+    ~FrameReader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->stop = true;
+        }
+        state_->changed.notify_all();
+        // The reader may be blocked in read() on a producer that never
+        // ends; it holds its own reference to the state, so let it go
+        thread_.detach();
+    }
+
+    /**
+     * @brief The next full slot, or null at the end of the stream.
+     *
+     * @throws the exception that stopped the reader.
+     */
+    InputSlot *next()
+    {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        InputSlot &slot = state_->slots[next_];
+        state_->changed.wait(lock, [&] {
+            return slot.full || state_->done;
+        });
+        if (slot.full)
+            return &slot;
+        if (state_->error)
+            std::rethrow_exception(state_->error);
+        return nullptr;
+    }
+
+    /**
+     * @brief Hand the slot returned by `next` back to the reader.
+     */
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->slots[next_].full = false;
+        }
+        state_->changed.notify_all();
+        next_ ^= 1;
+    }
+
+  private:
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable changed;
+        InputSlot slots[2];
+        bool stop = false;
+        bool done = false; ///< end of stream or error
+        std::exception_ptr error;
+    };
+
+    static void run(int fd, std::shared_ptr<State> state)
+    {
+        try
+        {
+            for (int i = 0;; i ^= 1)
+            {
+                InputSlot &slot = state->slots[i];
+                {
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    state->changed.wait(
+                        lock, [&] { return !slot.full || state->stop; });
+                    if (state->stop)
+                        return;
+                }
+                // The slot is not full, so the consumer does not touch it
+                FrameHeader header;
+                if (!read_frame_header(fd, header))
+                    break;
+                if (header.kind != static_cast<std::uint32_t>(
+                                       FrameKind::Matrix) ||
+                    header.rows != header.cols)
+                {
+                    throw std::runtime_error(
+                        "expected a square Matrix frame, got kind " +
+                        std::to_string(header.kind) + " of " +
+                        std::to_string(header.rows) + "x" +
+                        std::to_string(header.cols));
+                }
+                eigen_interface_detail::check_lapack_size(header.rows,
+                                                          header.cols);
+                slot.data.resize(header.rows * header.cols);
+                read_frame_payload(fd, header, slot.data.data());
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    slot.header = header;
+                    slot.full = true;
+                }
+                state->changed.notify_all();
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done = true;
+        }
+        state->changed.notify_all();
+    }
+
+    std::shared_ptr<State> state_;
+    std::thread thread_;
+    int next_ = 0;
+};
+
+/**
+ * @brief The memory of one output message.
+ *
+ * Large messages get a fresh anonymous mapping. Once spliced into a pipe,
+ * its pages are referenced by the pipe until the consumer reads them; they
+ * stay valid after munmap, whereas reusing the memory for the next message
+ * would change data the consumer has not read yet. Small messages reuse one
+ * heap buffer and are written with write().
+ */
+class OutputMessage
+{
+  public:
+    explicit OutputMessage(std::size_t bytes) : bytes_(bytes)
+    {
+        if (bytes_ >= splice_threshold)
+        {
+            void *data = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (data == MAP_FAILED)
+                throw std::runtime_error(
+                    std::string("cannot map output message: ") +
+                    std::strerror(errno));
+            data_ = static_cast<char *>(data);
+            mapped_ = true;
+        }
+        else
+        {
+            thread_local std::vector<double> small;
+            small.resize((bytes_ + sizeof(double) - 1) / sizeof(double));
+            data_ = reinterpret_cast<char *>(small.data());
+        }
+    }
+
+    ~OutputMessage()
+    {
+        if (mapped_)
+            munmap(data_, bytes_);
+    }
+
+    OutputMessage(const OutputMessage &) = delete;
+    OutputMessage &operator=(const OutputMessage &) = delete;
+
+    char *data()
+    {
+        return data_;
+    }
+
+    /**
+     * @brief Send the message to fd, spliced if fd is a pipe.
+     */
+    void send(int fd, bool pipe)
+    {
+        std::size_t done = 0;
+#ifdef __linux__
+        while (mapped_ && pipe && done < bytes_)
+        {
+            iovec iov{data_ + done, bytes_ - done};
+            const ssize_t put = vmsplice(fd, &iov, 1, 0);
+            if (put < 0 && errno == EINTR)
+                continue;
+            if (put < 0 && done == 0 && (errno == EINVAL || errno == ENOSYS))
+                break; // not supported here, fall back to write()
+            if (put < 0)
+                throw std::runtime_error(
+                    std::string("cannot splice output message: ") +
+                    std::strerror(errno));
+            done += put;
+        }
+#else
+        (void)pipe;
+#endif
+        write_full(fd, data_ + done, bytes_ - done);
+    }
+
+  private:
+    std::size_t bytes_;
+    char *data_ = nullptr;
+    bool mapped_ = false;
+};
+
+/**
+ * @brief Page-aligned anonymous memory, as O_DIRECT and buffer
+ * registration want it.
+ */
+class PageBuffer
+{
+  public:
+    explicit PageBuffer(std::size_t bytes)
+        : bytes_(std::max<std::size_t>(1, bytes))
+    {
+        void *data = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED)
+            throw std::runtime_error(std::string("cannot map buffer: ") +
+                                     std::strerror(errno));
+        data_ = static_cast<char *>(data);
+    }
+
+    ~PageBuffer()
+    {
+        munmap(data_, bytes_);
+    }
+
+    PageBuffer(const PageBuffer &) = delete;
+    PageBuffer &operator=(const PageBuffer &) = delete;
+
+    char *data()
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return bytes_;
+    }
+
+  private:
+    std::size_t bytes_;
+    char *data_;
+};
+
+/**
+ * @brief The size of the answer to an n x n matrix.
+ */
+std::size_t message_bytes(std::uint64_t n, bool vectors)
+{
+    const std::size_t values_bytes =
+        sizeof(FrameHeader) + 2 * n * sizeof(double);
+    const std::size_t vectors_bytes =
+        sizeof(FrameHeader) + n * n * sizeof(double);
+    return values_bytes + (vectors ? vectors_bytes : 0);
+}
+
+/**
+ * @brief Decompose the n x n matrix at a, destroying it, and lay out the
+ * answer in message (`message_bytes(n, vectors)` bytes).
+ */
+void decompose_into(double *a, lapack_int n, bool vectors, char *message)
+{
+    // [values header][wr][wi]([vectors header][V])
+    const FrameHeader values = frame_header(FrameKind::Eigenvalues, n, 2);
+    std::memcpy(message, &values, sizeof values);
+    double *wr = reinterpret_cast<double *>(message + sizeof values);
+    double *wi = wr + n;
+    double dummy;
+    double *v = &dummy;
+    if (vectors)
+    {
+        const FrameHeader header = frame_header(FrameKind::Eigenvectors, n, n);
+        char *at = message + message_bytes(n, false);
+        std::memcpy(at, &header, sizeof header);
+        v = reinterpret_cast<double *>(at + sizeof header);
+    }
+
+    const char job = vectors ? 'V' : 'N';
+    auto ws = eigen_interface_detail::lease_eigen_workspace(n, job, false);
+    eigen_interface_detail::solve_eigen(
+        n, a, std::max<lapack_int>(1, n), job, wr, wi, v,
+        vectors ? std::max<lapack_int>(1, n) : 1, ws);
+}
+
+/**
+ * @brief Decompose the matrix in a slot and send the answer.
+ */
+void answer(InputSlot &slot, bool vectors, int out, bool pipe)
+{
+    const auto n = static_cast<lapack_int>(slot.header.rows);
+    OutputMessage message(message_bytes(n, vectors));
+    decompose_into(slot.data.data(), n, vectors, message.data());
+    message.send(out, pipe);
+}
+
+struct BatchOptions
+{
+    std::string input;
+    std::string output;
+    std::string io = "auto";
+    bool direct = false;
+    unsigned depth = 2;
+    bool mmap_output = false;
+};
+
+/**
+ * @brief O_DIRECT transfers must start and end on this boundary.
+ */
+constexpr std::size_t direct_alignment = 4096;
+
+std::size_t align_up(std::size_t value)
+{
+    return (value + direct_alignment - 1) / direct_alignment *
+           direct_alignment;
+}
+
+struct InputFrame
+{
+    off_t payload_offset;
+    std::uint64_t n;
+};
+
+/**
+ * @brief Locate the Matrix frames of a file.
+ */
+std::vector<InputFrame> scan_frames(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path + ": " +
+                                 std::strerror(errno));
+    std::vector<InputFrame> frames;
+    try
+    {
+        struct stat file_stat;
+        fstat(fd, &file_stat);
+        FrameHeader header;
+        off_t offset = 0;
+        while (read_frame_header(fd, header))
+        {
+            if (header.kind !=
+                    static_cast<std::uint32_t>(FrameKind::Matrix) ||
+                header.rows != header.cols)
+                throw std::runtime_error("frame " +
+                                         std::to_string(frames.size()) +
+                                         " is not a square Matrix frame");
+            eigen_interface_detail::check_lapack_size(header.rows,
+                                                      header.cols);
+            offset += sizeof header;
+            frames.push_back({offset, header.rows});
+            offset += frame_payload_bytes(header);
+            if (offset > file_stat.st_size)
+                throw std::runtime_error("truncated matrix frame payload");
+            lseek(fd, offset, SEEK_SET);
+        }
+    }
+    catch (...)
+    {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    return frames;
+}
+
+/**
+ * @brief Decompose every matrix of a file and write the answers to another
+ * file, overlapping the I/O with the decompositions.
+ *
+ * There are depth input and depth output buffers. While matrix i is
+ * decomposed, the following depth - 1 matrices are being read and up to
+ * depth - 1 earlier answers written. The answers go to offsets computed up
+ * front, so writes may finish in any order. With options.mmap_output, the
+ * answers are computed straight into the mapped output file instead and
+ * only the reads go through the engine.
+ */
+void run_batch(const BatchOptions &options, bool vectors)
+{
+    const std::vector<InputFrame> frames = scan_frames(options.input);
+    const unsigned depth = options.depth;
+    std::unique_ptr<IoEngine> engine = make_io_engine(options.io, 2 * depth);
+
+#ifdef O_DIRECT
+    const int direct_flag = options.direct ? O_DIRECT : 0;
+#else
+    if (options.direct)
+        throw std::runtime_error("O_DIRECT is not supported on this system");
+    const int direct_flag = 0;
+#endif
+    const int in = open(options.input.c_str(), O_RDONLY | direct_flag);
+    if (in < 0)
+        throw std::runtime_error("cannot open " + options.input +
+                                 (options.direct ? " with O_DIRECT: " : ": ") +
+                                 std::strerror(errno));
+    // Every read lands in an input buffer: with O_DIRECT, the payload is
+    // surrounded by the rest of its first and last blocks
+    std::size_t in_bytes = 0;
+    std::size_t out_bytes = 0;
+    std::vector<off_t> out_offsets;
+    off_t out_offset = 0;
+    for (const InputFrame &frame : frames)
+    {
+        const std::size_t payload = frame.n * frame.n * sizeof(double);
+        in_bytes = std::max(in_bytes, options.direct
+                                          ? align_up(payload) +
+                                                direct_alignment
+                                          : payload);
+        out_bytes = std::max(out_bytes, message_bytes(frame.n, vectors));
+        out_offsets.push_back(out_offset);
+        out_offset += message_bytes(frame.n, vectors);
+    }
+
+    int out = -1;
+    std::unique_ptr<MappedFrameFile> mapped;
+    try
+    {
+        if (options.mmap_output)
+            mapped.reset(new MappedFrameFile(options.output, out_offset));
+    }
+    catch (...)
+    {
+        close(in);
+        throw;
+    }
+    if (!mapped)
+        out = open(options.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                   0644);
+    if (!mapped && out < 0)
+    {
+        close(in);
+        throw std::runtime_error("cannot create " + options.output + ": " +
+                                 std::strerror(errno));
+    }
+
+    std::vector<std::unique_ptr<PageBuffer>> buffers;
+    std::vector<iovec> iovecs;
+    for (unsigned b = 0; b < (mapped ? depth : 2 * depth); ++b)
+    {
+        buffers.emplace_back(new PageBuffer(b < depth ? in_bytes : out_bytes));
+        iovecs.push_back({buffers.back()->data(), buffers.back()->size()});
+    }
+    const bool registered = engine->register_buffers(iovecs);
+    const std::string engine_name = engine->name();
+
+    // Read of frame i: tag 2i, write of its answer: tag 2i + 1
+    std::vector<double *> payloads(frames.size());
+    std::vector<std::size_t> needed(frames.size());
+    std::vector<char> read_done(frames.size(), 0);
+    std::vector<char> writing(depth, 0);
+    const auto submit_read = [&](std::size_t i) {
+        const unsigned slot = i % depth;
+        const off_t offset = frames[i].payload_offset;
+        const std::size_t payload = frames[i].n * frames[i].n * sizeof(double);
+        off_t start = offset;
+        std::size_t bytes = payload;
+        if (options.direct)
+        {
+            start = offset / direct_alignment * direct_alignment;
+            bytes = align_up(offset + payload - start);
+        }
+        char *data = buffers[slot]->data();
+        payloads[i] = reinterpret_cast<double *>(data + (offset - start));
+        needed[i] = offset + payload - start;
+        engine->read(in, data, bytes, start, slot, 2 * i);
+    };
+    const auto handle = [&](const IoCompletion &completion) {
+        const std::size_t i = completion.tag / 2;
+        if (completion.tag % 2 == 1)
+            writing[i % depth] = 0;
+        else if (completion.bytes < needed[i])
+            throw std::runtime_error("truncated matrix frame payload");
+        else
+            read_done[i] = 1;
+    };
+
+    const auto start_time = std::chrono::steady_clock::now();
+    try
+    {
+        for (std::size_t i = 0; i < frames.size() && i < depth; ++i)
+            submit_read(i);
+        for (std::size_t i = 0; i < frames.size(); ++i)
+        {
+            const unsigned slot = i % depth;
+            while (!read_done[i] || writing[slot])
+                handle(engine->wait());
+            const auto n = static_cast<lapack_int>(frames[i].n);
+            if (mapped)
+            {
+                decompose_into(payloads[i], n, vectors,
+                               mapped->data() + out_offsets[i]);
+            }
+            else
+            {
+                char *message = buffers[depth + slot]->data();
+                decompose_into(payloads[i], n, vectors, message);
+                engine->write(out, message, message_bytes(n, vectors),
+                              out_offsets[i], depth + slot, 2 * i + 1);
+                writing[slot] = 1;
+            }
+            if (i + depth < frames.size())
+                submit_read(i + depth);
+        }
+        while (engine->pending() != 0)
+            handle(engine->wait());
+        if (mapped)
+            mapped->sync();
+    }
+    catch (...)
+    {
+        engine.reset();
+        close(in);
+        if (out >= 0)
+            close(out);
+        throw;
+    }
+    engine.reset();
+    close(in);
+    if (out >= 0 && close(out) != 0)
+        throw std::runtime_error("cannot write " + options.output + ": " +
+                                 std::strerror(errno));
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start_time)
+                               .count();
+    std::cerr << "eigsolve: " << frames.size() << " matrices in " << seconds
+              << " s, " << engine_name << " I/O"
+              << (registered ? "" : " (buffers not registered)")
+              << (options.direct ? ", O_DIRECT input" : "")
+              << (mapped ? ", mapped output" : "") << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief The main entry point of the filter.
+ *
+ * @return Returns 0 if the program executed successfully, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    bool binary = false;
+    bool vectors = true;
+    bool valid = true;
+    BatchOptions batch;
+    for (int i = 1; i < argc && valid; ++i)
+    {
+        const std::string arg = argv[i];
+        const std::size_t eq = arg.find('=');
+        const std::string name = arg.substr(0, eq);
+        const std::string value =
+            eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (arg == "--binary")
+            binary = true;
+        else if (arg == "--values-only")
+            vectors = false;
+        else if (name == "--input" && !value.empty())
+            batch.input = value;
+        else if (name == "--output" && !value.empty())
+            batch.output = value;
+        else if (name == "--io" && !value.empty())
+            batch.io = value;
+        else if (arg == "--direct")
+            batch.direct = true;
+        else if (arg == "--mmap-output")
+            batch.mmap_output = true;
+        else if (name == "--depth")
+        {
+            batch.depth = std::strtoul(value.c_str(), nullptr, 10);
+            valid = batch.depth > 0;
+        }
+        else
+            valid = false;
+    }
+    if (!binary || !valid || batch.input.empty() != batch.output.empty())
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " --binary [--values-only]\n"
+                     "       [--input=FILE --output=FILE"
+                     " [--io=auto|uring|sync] [--direct] [--depth=N]\n"
+                     "        [--mmap-output]]\n"
+                  << "Reads Matrix frames from stdin (or FILE) and writes "
+                     "their eigenvalues and eigenvectors to stdout (or FILE) "
+                     "as frames."
+                  << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        if (!batch.input.empty())
+        {
+            run_batch(batch, vectors);
+            return 0;
+        }
+        struct stat out_stat;
+        const bool pipe = fstat(STDOUT_FILENO, &out_stat) == 0 &&
+                          S_ISFIFO(out_stat.st_mode);
+#ifdef F_SETPIPE_SZ
+        // Bigger pipe buffers mean fewer wake-ups per message; best effort
+        if (pipe)
+            fcntl(STDOUT_FILENO, F_SETPIPE_SZ, 1 << 20);
+#endif
+        FrameReader reader(STDIN_FILENO);
+        while (InputSlot *slot = reader.next())
+        {
+            answer(*slot, vectors, STDOUT_FILENO, pipe);
+            reader.release();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in eigsolve: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file energy_meter.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the RAPL energy meter.
+ */
+
+#include "energy_meter.h"
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+
+namespace
+{
+
+bool read_value(const std::string &path, std::string &value)
+{
+    std::ifstream file(path);
+    return static_cast<bool>(std::getline(file, value));
+}
+
+bool read_value(const std::string &path, std::uint64_t &value)
+{
+    std::ifstream file(path);
+    return static_cast<bool>(file >> value);
+}
+
+} // namespace
+
+EnergyMeter::EnergyMeter(const std::string &root)
+{
+    DIR *dir = opendir(root.c_str());
+    if (dir == nullptr)
+        return;
+    std::vector<std::string> entries;
+    while (const dirent *entry = readdir(dir))
+    {
+        const std::string name = entry->d_name;
+        if (name.compare(0, 11, "intel-rapl:") == 0)
+            entries.push_back(name);
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+
+    // Subzones such as intel-rapl:0:1 are listed at the top level as well;
+    // intel-rapl-mmio duplicates the package zone and is not matched
+    for (const std::string &entry : entries)
+    {
+        const std::string path = root + "/" + entry;
+        std::string name;
+        Zone zone;
+        std::uint64_t probe;
+        if (!read_value(path + "/name", name) ||
+            !read_value(path + "/max_energy_range_uj", zone.range) ||
+            !read_value(path + "/energy_uj", probe))
+            continue;
+        if (name.compare(0, 8, "package-") == 0)
+            zone.dram = false;
+        else if (name == "dram")
+            zone.dram = true;
+        else
+            continue;
+        zone.counter = path + "/energy_uj";
+        zones_.push_back(zone);
+    }
+}
+
+EnergyMeter::Reading EnergyMeter::read() const
+{
+    Reading reading(zones_.size(), 0);
+    for (std::size_t z = 0; z < zones_.size(); ++z)
+        read_value(zones_[z].counter, reading[z]);
+    return reading;
+}
+
+EnergyUsage EnergyMeter::since(const Reading &start) const
+{
+    EnergyUsage usage;
+    const Reading now = read();
+    for (std::size_t z = 0; z < zones_.size() && z < start.size(); ++z)
+    {
+        const Zone &zone = zones_[z];
+        const std::uint64_t delta = now[z] >= start[z]
+                                        ? now[z] - start[z]
+                                        : now[z] + zone.range - start[z];
+        const double joules = static_cast<double>(delta) * 1e-6;
+        if (zone.dram)
+        {
+            usage.dram += joules;
+            usage.has_dram = true;
+        }
+        else
+            usage.package += joules;
+    }
+    return usage;
+}
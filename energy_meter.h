@@ -0,0 +1,100 @@
+/**
+ * @file energy_meter.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines an energy meter based on the RAPL
+ * counters of Intel and AMD processors.
+ *
+ * Linux exposes RAPL through the powercap framework: every zone
+ * /sys/class/powercap/intel-rapl:P (and its subzones intel-rapl:P:S) has a
+ * name ("package-P", "dram", "core", ...), a cumulative energy_uj counter in
+ * microjoules and the max_energy_range_uj at which that counter wraps
+ * around. The meter sums the package and DRAM zones; core and uncore are
+ * contained in the package and are skipped. On machines without RAPL, or
+ * where the counters are readable only by root, the meter is simply not
+ * available.
+ */
+
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The energy used over an interval, in joules.
+ */
+struct EnergyUsage
+{
+    double package = 0.0; ///< all package-P zones
+    double dram = 0.0;    ///< all dram zones, 0 if there are none
+    bool has_dram = false;
+
+    double total() const
+    {
+        return package + dram;
+    }
+};
+
+/**
+ * @brief Reads the RAPL package and DRAM counters.
+ *
+ * Typical use:
+ * @code
+ * EnergyMeter meter;
+ * const auto start = meter.read();
+ * run();
+ * if (meter.available())
+ *     std::cout << meter.since(start).total() << " J\n";
+ * @endcode
+ */
+class EnergyMeter
+{
+  public:
+    /**
+     * @brief The raw counters of all zones, in microjoules.
+     */
+    using Reading = std::vector<std::uint64_t>;
+
+    /**
+     * @brief Find the package and DRAM zones.
+     *
+     * @param root The powercap directory.
+     */
+    explicit EnergyMeter(const std::string &root = "/sys/class/powercap");
+
+    /**
+     * @brief Whether any zone was found and could be read.
+     */
+    bool available() const
+    {
+        return !zones_.empty();
+    }
+
+    /**
+     * @brief The current counters; empty if the meter is not available.
+     */
+    Reading read() const;
+
+    /**
+     * @brief The energy used since start.
+     *
+     * A counter that is lower than at start wrapped around once; intervals
+     * long enough to wrap twice (hours at typical package power) cannot be
+     * told apart from that and are undercounted.
+     */
+    EnergyUsage since(const Reading &start) const;
+
+  private:
+    struct Zone
+    {
+        std::string counter; ///< path of energy_uj
+        std::uint64_t range; ///< max_energy_range_uj
+        bool dram;
+    };
+
+    std::vector<Zone> zones_;
+};
+
+#endif // ENERGY_METER_H
@@ -0,0 +1,1112 @@
+/**
+ * @file fixed_size_eigen.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines eigensolvers for matrices whose size is
+ * known at compile time.
+ *
+ * For small matrices (roughly 5 <= N <= 32) the fixed cost of the LAPACK path
+ * - copying into a dynamic matrix, the Fortran call and its workspace
+ * allocations - dominates the actual arithmetic. The solvers in this file keep
+ * all their storage on the stack and take N as a template parameter, so every
+ * loop bound is a compile time constant. Matrices that are updated a column
+ * at a time (the eigenvectors, the symmetric input) are stored by columns,
+ * and the updates are `#pragma omp simd` loops over contiguous memory; the
+ * row sweeps of Jacobi, which cut across the columns, are unrolled through
+ * `fixed_detail::Unroll`.
+ *
+ * Three solvers are provided:
+ * - `fixed_eigen_decomposition` for general real matrices: Householder
+ *   reduction to Hessenberg form followed by the Francis double shift QR
+ *   iteration and back substitution for the eigenvectors.
+ * - `fixed_symmetric_eigen_decomposition` for symmetric matrices:
+ *   Householder reduction to tridiagonal form and the implicit QL iteration.
+ * - `fixed_jacobi_eigen_decomposition` for symmetric matrices: the cyclic
+ *   Jacobi method, slower but more accurate for graded matrices.
+ *
+ * All throw a runtime_error if the iteration does not converge.
+ */
+
+#ifndef FIXED_SIZE_EIGEN_H
+#define FIXED_SIZE_EIGEN_H
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace fixed_detail
+{
+
+/**
+ * @brief Compile time loop: calls f(I), f(I+1), ..., f(End-1).
+ */
+template <int I, int End>
+struct Unroll
+{
+    template <typename F>
+    static inline void run(F &&f)
+    {
+        f(I);
+        Unroll<I + 1, End>::run(f);
+    }
+};
+
+template <int End>
+struct Unroll<End, End>
+{
+    template <typename F>
+    static inline void run(F &&)
+    {
+    }
+};
+
+/**
+ * @brief Complex division (xr + i*xi) / (yr + i*yi) without overflow.
+ */
+inline void cdiv(double xr, double xi, double yr, double yi, double &cr,
+                 double &ci)
+{
+    if (std::abs(yr) > std::abs(yi))
+    {
+        const double r = yi / yr;
+        const double d = yr + r * yi;
+        cr = (xr + r * xi) / d;
+        ci = (xi - r * xr) / d;
+    }
+    else
+    {
+        const double r = yr / yi;
+        const double d = yi + r * yr;
+        cr = (r * xr + xi) / d;
+        ci = (r * xi - xr) / d;
+    }
+}
+
+/**
+ * @brief Reduce H to upper Hessenberg form by Householder similarity
+ * transformations and accumulate them in V.
+ *
+ * V is stored by columns, Vt[j][i] = V(i, j), so that every update of V
+ * below (and in `francis_qr`) runs over contiguous memory.
+ */
+template <int N>
+inline void hessenberg(double (&H)[N][N], double (&Vt)[N][N])
+{
+    double ort[N] = {};
+    double f[N];
+    for (int m = 1; m < N - 1; ++m)
+    {
+        double scale = 0.0;
+        for (int i = m; i < N; ++i)
+            scale += std::abs(H[i][m - 1]);
+        if (scale == 0.0)
+            continue;
+
+        double h = 0.0;
+        for (int i = N - 1; i >= m; --i)
+        {
+            ort[i] = H[i][m - 1] / scale;
+            h += ort[i] * ort[i];
+        }
+        double g = std::sqrt(h);
+        if (ort[m] > 0)
+            g = -g;
+        h -= ort[m] * g;
+        ort[m] -= g;
+
+        // H = (I - u u'/h) H, row by row: f' = u' H, then H -= u f'/h
+        for (int j = m; j < N; ++j)
+            f[j] = 0.0;
+        for (int i = m; i < N; ++i)
+        {
+            const double u = ort[i];
+#pragma omp simd
+            for (int j = m; j < N; ++j)
+                f[j] += u * H[i][j];
+        }
+        for (int i = m; i < N; ++i)
+        {
+            const double u = ort[i] / h;
+#pragma omp simd
+            for (int j = m; j < N; ++j)
+                H[i][j] -= f[j] * u;
+        }
+        // H = H (I - u u'/h)
+        for (int i = 0; i < N; ++i)
+        {
+            double fi = 0.0;
+#pragma omp simd reduction(+ : fi)
+            for (int j = m; j < N; ++j)
+                fi += ort[j] * H[i][j];
+            fi /= h;
+#pragma omp simd
+            for (int j = m; j < N; ++j)
+                H[i][j] -= fi * ort[j];
+        }
+        ort[m] *= scale;
+        H[m][m - 1] = scale * g;
+    }
+
+    for (int j = 0; j < N; ++j)
+        for (int i = 0; i < N; ++i)
+            Vt[j][i] = (i == j) ? 1.0 : 0.0;
+    for (int m = N - 2; m >= 1; --m)
+    {
+        if (H[m][m - 1] == 0.0)
+            continue;
+        for (int i = m + 1; i < N; ++i)
+            ort[i] = H[i][m - 1];
+        for (int j = m; j < N; ++j)
+        {
+            double g = 0.0;
+#pragma omp simd reduction(+ : g)
+            for (int i = m; i < N; ++i)
+                g += ort[i] * Vt[j][i];
+            // Double division avoids possible underflow
+            g = (g / ort[m]) / H[m][m - 1];
+#pragma omp simd
+            for (int i = m; i < N; ++i)
+                Vt[j][i] += g * ort[i];
+        }
+    }
+}
+
+/**
+ * @brief Francis double shift QR iteration on the Hessenberg matrix H,
+ * followed by back substitution for the eigenvectors.
+ *
+ * On exit wr/wi hold the eigenvalues and V the eigenvectors in LAPACK's
+ * convention: a complex pair wr[j] +- i*wi[j] (wi[j] > 0) has the eigenvector
+ * V(:,j) +- i*V(:,j+1). V is stored by columns as in `hessenberg`.
+ *
+ * @return false if the iteration did not converge.
+ */
+template <int N>
+inline bool francis_qr(double (&H)[N][N], double (&Vt)[N][N],
+                       double (&wr)[N], double (&wi)[N])
+{
+    const double eps = std::numeric_limits<double>::epsilon();
+    const int max_iter = 30 * std::max(10, N);
+    double exshift = 0.0;
+    double p = 0, q = 0, r = 0, s = 0, z = 0, t, w, x, y;
+
+    double norm = 0.0;
+    for (int i = 0; i < N; ++i)
+        for (int j = std::max(i - 1, 0); j < N; ++j)
+            norm += std::abs(H[i][j]);
+
+    int n = N - 1;
+    int iter = 0;
+    int total_iter = 0;
+    while (n >= 0)
+    {
+        // Look for a single small sub-diagonal element
+        int l = n;
+        while (l > 0)
+        {
+            s = std::abs(H[l - 1][l - 1]) + std::abs(H[l][l]);
+            if (s == 0.0)
+                s = norm;
+            if (std::abs(H[l][l - 1]) < eps * s || H[l][l - 1] == 0.0)
+                break;
+            --l;
+        }
+
+        if (l == n)
+        {
+            // One root found
+            H[n][n] += exshift;
+            wr[n] = H[n][n];
+            wi[n] = 0.0;
+            --n;
+            iter = 0;
+        }
+        else if (l == n - 1)
+        {
+            // Two roots found
+            w = H[n][n - 1] * H[n - 1][n];
+            p = (H[n - 1][n - 1] - H[n][n]) / 2.0;
+            q = p * p + w;
+            z = std::sqrt(std::abs(q));
+            H[n][n] += exshift;
+            H[n - 1][n - 1] += exshift;
+            x = H[n][n];
+
+            if (q >= 0)
+            {
+                // Real pair
+                z = (p >= 0) ? p + z : p - z;
+                wr[n - 1] = x + z;
+                wr[n] = wr[n - 1];
+                if (z != 0.0)
+                    wr[n] = x - w / z;
+                wi[n - 1] = 0.0;
+                wi[n] = 0.0;
+                x = H[n][n - 1];
+                s = std::abs(x) + std::abs(z);
+                p = x / s;
+                q = z / s;
+                r = std::sqrt(p * p + q * q);
+                p /= r;
+                q /= r;
+
+                for (int j = n - 1; j < N; ++j)
+                {
+                    z = H[n - 1][j];
+                    H[n - 1][j] = q * z + p * H[n][j];
+                    H[n][j] = q * H[n][j] - p * z;
+                }
+                for (int i = 0; i <= n; ++i)
+                {
+                    z = H[i][n - 1];
+                    H[i][n - 1] = q * z + p * H[i][n];
+                    H[i][n] = q * H[i][n] - p * z;
+                }
+                double *v0 = Vt[n - 1];
+                double *v1 = Vt[n];
+#pragma omp simd
+                for (int i = 0; i < N; ++i)
+                {
+                    const double v = v0[i];
+                    v0[i] = q * v + p * v1[i];
+                    v1[i] = q * v1[i] - p * v;
+                }
+            }
+            else
+            {
+                // Complex pair
+                wr[n - 1] = x + p;
+                wr[n] = x + p;
+                wi[n - 1] = z;
+                wi[n] = -z;
+            }
+            n -= 2;
+            iter = 0;
+        }
+        else
+        {
+            if (++total_iter > max_iter)
+                return false;
+
+            // Form shift
+            x = H[n][n];
+            y = 0.0;
+            w = 0.0;
+            if (l < n)
+            {
+                y = H[n - 1][n - 1];
+                w = H[n][n - 1] * H[n - 1][n];
+            }
+
+            // Wilkinson's original ad hoc shift
+            if (iter == 10)
+            {
+                exshift += x;
+                for (int i = 0; i <= n; ++i)
+                    H[i][i] -= x;
+                s = std::abs(H[n][n - 1]) + std::abs(H[n - 1][n - 2]);
+                x = y = 0.75 * s;
+                w = -0.4375 * s * s;
+            }
+
+            // MATLAB's ad hoc shift
+            if (iter == 30)
+            {
+                s = (y - x) / 2.0;
+                s = s * s + w;
+                if (s > 0)
+                {
+                    s = std::sqrt(s);
+                    if (y < x)
+                        s = -s;
+                    s = x - w / ((y - x) / 2.0 + s);
+                    for (int i = 0; i <= n; ++i)
+                        H[i][i] -= s;
+                    exshift += s;
+                    x = y = w = 0.964;
+                }
+            }
+            ++iter;
+
+            // Look for two consecutive small sub-diagonal elements
+            int m = n - 2;
+            while (m >= l)
+            {
+                z = H[m][m];
+                r = x - z;
+                s = y - z;
+                p = (r * s - w) / H[m + 1][m] + H[m][m + 1];
+                q = H[m + 1][m + 1] - z - r - s;
+                r = H[m + 2][m + 1];
+                s = std::abs(p) + std::abs(q) + std::abs(r);
+                p /= s;
+                q /= s;
+                r /= s;
+                if (m == l)
+                    break;
+                if (std::abs(H[m][m - 1]) * (std::abs(q) + std::abs(r)) <
+                    eps * (std::abs(p) *
+                           (std::abs(H[m - 1][m - 1]) + std::abs(z) +
+                            std::abs(H[m + 1][m + 1]))))
+                    break;
+                --m;
+            }
+            for (int i = m + 2; i <= n; ++i)
+            {
+                H[i][i - 2] = 0.0;
+                if (i > m + 2)
+                    H[i][i - 3] = 0.0;
+            }
+
+            // Double QR step involving rows l:n and columns m:n
+            for (int k = m; k <= n - 1; ++k)
+            {
+                const bool notlast = (k != n - 1);
+                if (k != m)
+                {
+                    p = H[k][k - 1];
+                    q = H[k + 1][k - 1];
+                    r = notlast ? H[k + 2][k - 1] : 0.0;
+                    x = std::abs(p) + std::abs(q) + std::abs(r);
+                    if (x == 0.0)
+                        continue;
+                    p /= x;
+                    q /= x;
+                    r /= x;
+                }
+                s = std::sqrt(p * p + q * q + r * r);
+                if (p < 0)
+                    s = -s;
+                if (s == 0.0)
+                    continue;
+
+                if (k != m)
+                    H[k][k - 1] = -s * x;
+                else if (l != m)
+                    H[k][k - 1] = -H[k][k - 1];
+                p += s;
+                x = p / s;
+                y = q / s;
+                z = r / s;
+                q /= p;
+                r /= p;
+
+                double *h0 = H[k];
+                double *h1 = H[k + 1];
+                if (notlast)
+                {
+                    double *h2 = H[k + 2];
+#pragma omp simd
+                    for (int j = k; j < N; ++j)
+                    {
+                        const double pj = h0[j] + q * h1[j] + r * h2[j];
+                        h0[j] -= pj * x;
+                        h1[j] -= pj * y;
+                        h2[j] -= pj * z;
+                    }
+                }
+                else
+                {
+#pragma omp simd
+                    for (int j = k; j < N; ++j)
+                    {
+                        const double pj = h0[j] + q * h1[j];
+                        h0[j] -= pj * x;
+                        h1[j] -= pj * y;
+                    }
+                }
+                for (int i = 0; i <= std::min(n, k + 3); ++i)
+                {
+                    p = x * H[i][k] + y * H[i][k + 1];
+                    if (notlast)
+                    {
+                        p += z * H[i][k + 2];
+                        H[i][k + 2] -= p * r;
+                    }
+                    H[i][k] -= p;
+                    H[i][k + 1] -= p * q;
+                }
+                double *v0 = Vt[k];
+                double *v1 = Vt[k + 1];
+                if (notlast)
+                {
+                    double *v2 = Vt[k + 2];
+#pragma omp simd
+                    for (int i = 0; i < N; ++i)
+                    {
+                        const double pv = x * v0[i] + y * v1[i] + z * v2[i];
+                        v0[i] -= pv;
+                        v1[i] -= pv * q;
+                        v2[i] -= pv * r;
+                    }
+                }
+                else
+                {
+#pragma omp simd
+                    for (int i = 0; i < N; ++i)
+                    {
+                        const double pv = x * v0[i] + y * v1[i];
+                        v0[i] -= pv;
+                        v1[i] -= pv * q;
+                    }
+                }
+            }
+        }
+    }
+
+    // Back substitute to find the vectors of the upper triangular form
+    if (norm == 0.0)
+        return true;
+
+    for (n = N - 1; n >= 0; --n)
+    {
+        p = wr[n];
+        q = wi[n];
+
+        if (q == 0)
+        {
+            // Real vector
+            int l = n;
+            H[n][n] = 1.0;
+            for (int i = n - 1; i >= 0; --i)
+            {
+                w = H[i][i] - p;
+                r = 0.0;
+                for (int j = l; j <= n; ++j)
+                    r += H[i][j] * H[j][n];
+                if (wi[i] < 0.0)
+                {
+                    z = w;
+                    s = r;
+                    continue;
+                }
+                l = i;
+                if (wi[i] == 0.0)
+                {
+                    H[i][n] = (w != 0.0) ? -r / w : -r / (eps * norm);
+                }
+                else
+                {
+                    // Solve real equations
+                    x = H[i][i + 1];
+                    y = H[i + 1][i];
+                    q = (wr[i] - p) * (wr[i] - p) + wi[i] * wi[i];
+                    t = (x * s - z * r) / q;
+                    H[i][n] = t;
+                    H[i + 1][n] = (std::abs(x) > std::abs(z))
+                                      ? (-r - w * t) / x
+                                      : (-s - y * t) / z;
+                }
+                // Overflow control
+                t = std::abs(H[i][n]);
+                if ((eps * t) * t > 1)
+                    for (int j = i; j <= n; ++j)
+                        H[j][n] /= t;
+            }
+        }
+        else if (q < 0)
+        {
+            // Complex vector, last component imaginary so the matrix is
+            // triangular
+            int l = n - 1;
+            if (std::abs(H[n][n - 1]) > std::abs(H[n - 1][n]))
+            {
+                H[n - 1][n - 1] = q / H[n][n - 1];
+                H[n - 1][n] = -(H[n][n] - p) / H[n][n - 1];
+            }
+            else
+            {
+                cdiv(0.0, -H[n - 1][n], H[n - 1][n - 1] - p, q,
+                     H[n - 1][n - 1], H[n - 1][n]);
+            }
+            H[n][n - 1] = 0.0;
+            H[n][n] = 1.0;
+            for (int i = n - 2; i >= 0; --i)
+            {
+                double ra = 0.0;
+                double sa = 0.0;
+                for (int j = l; j <= n; ++j)
+                {
+                    ra += H[i][j] * H[j][n - 1];
+                    sa += H[i][j] * H[j][n];
+                }
+                w = H[i][i] - p;
+
+                if (wi[i] < 0.0)
+                {
+                    z = w;
+                    r = ra;
+                    s = sa;
+                    continue;
+                }
+                l = i;
+                if (wi[i] == 0.0)
+                {
+                    cdiv(-ra, -sa, w, q, H[i][n - 1], H[i][n]);
+                }
+                else
+                {
+                    // Solve complex equations
+                    x = H[i][i + 1];
+                    y = H[i + 1][i];
+                    double vr =
+                        (wr[i] - p) * (wr[i] - p) + wi[i] * wi[i] - q * q;
+                    const double vi = (wr[i] - p) * 2.0 * q;
+                    if (vr == 0.0 && vi == 0.0)
+                        vr = eps * norm *
+                             (std::abs(w) + std::abs(q) + std::abs(x) +
+                              std::abs(y) + std::abs(z));
+                    cdiv(x * r - z * ra + q * sa, x * s - z * sa - q * ra, vr,
+                         vi, H[i][n - 1], H[i][n]);
+                    if (std::abs(x) > (std::abs(z) + std::abs(q)))
+                    {
+                        H[i + 1][n - 1] =
+                            (-ra - w * H[i][n - 1] + q * H[i][n]) / x;
+                        H[i + 1][n] = (-sa - w * H[i][n] - q * H[i][n - 1]) / x;
+                    }
+                    else
+                    {
+                        cdiv(-r - y * H[i][n - 1], -s - y * H[i][n], z, q,
+                             H[i + 1][n - 1], H[i + 1][n]);
+                    }
+                }
+                // Overflow control
+                t = std::max(std::abs(H[i][n - 1]), std::abs(H[i][n]));
+                if ((eps * t) * t > 1)
+                {
+                    for (int j = i; j <= n; ++j)
+                    {
+                        H[j][n - 1] /= t;
+                        H[j][n] /= t;
+                    }
+                }
+            }
+        }
+    }
+
+    // Back transformation to the eigenvectors of the original matrix:
+    // column j of V becomes sum over k <= j of H[k][j] times column k
+    for (int j = N - 1; j >= 0; --j)
+    {
+        double sum[N] = {};
+        for (int k = 0; k <= j; ++k)
+        {
+            const double h = H[k][j];
+            const double *vk = Vt[k];
+#pragma omp simd
+            for (int i = 0; i < N; ++i)
+                sum[i] += h * vk[i];
+        }
+#pragma omp simd
+        for (int i = 0; i < N; ++i)
+            Vt[j][i] = sum[i];
+    }
+    return true;
+}
+
+/**
+ * @brief Normalize the eigenvectors to unit Euclidean norm, treating the two
+ * columns of a complex pair as the real and imaginary part of one vector.
+ *
+ * V is stored by columns as in `hessenberg`.
+ */
+template <int N>
+inline void normalize_eigenvectors(double (&Vt)[N][N], const double (&wi)[N])
+{
+    for (int j = 0; j < N; ++j)
+    {
+        const bool pair = (wi[j] != 0.0 && j + 1 < N);
+        const int columns = pair ? 2 : 1;
+        double sq = 0.0;
+        for (int c = j; c < j + columns; ++c)
+        {
+#pragma omp simd reduction(+ : sq)
+            for (int i = 0; i < N; ++i)
+                sq += Vt[c][i] * Vt[c][i];
+        }
+        if (sq > 0.0)
+        {
+            const double inv = 1.0 / std::sqrt(sq);
+            for (int c = j; c < j + columns; ++c)
+            {
+#pragma omp simd
+                for (int i = 0; i < N; ++i)
+                    Vt[c][i] *= inv;
+            }
+        }
+        j += columns - 1;
+    }
+}
+
+/**
+ * @brief sqrt(x^2 + y^2), falling back to `std::hypot` only where the
+ * squares could overflow or underflow.
+ */
+inline double hypot(double x, double y)
+{
+    const double r = std::sqrt(x * x + y * y);
+    if (r > 1e-150 && r < 1e150)
+        return r;
+    return std::hypot(x, y);
+}
+
+/**
+ * @brief The cyclic Jacobi method on the symmetric matrix a, stored by
+ * columns (a[j][i] = A(i, j), both triangles), accumulating the rotations
+ * in the columns vt[j] of V.
+ *
+ * On exit the eigenvalues are on the diagonal of a.
+ *
+ * @return false if the sweeps did not converge.
+ */
+template <int N>
+inline bool jacobi(double (&a)[N][N], double (&vt)[N][N])
+{
+    const int max_sweeps = 50;
+    const double eps = std::numeric_limits<double>::epsilon();
+    for (int sweep = 0; sweep < max_sweeps; ++sweep)
+    {
+        double off = 0.0;
+        double diag = 0.0;
+        for (int q = 1; q < N; ++q)
+            for (int p = 0; p < q; ++p)
+                off += a[q][p] * a[q][p];
+        Unroll<0, N>::run([&](int i) { diag += a[i][i] * a[i][i]; });
+        if (off <= eps * eps * diag || off == 0.0)
+            return true;
+
+        for (int p = 0; p < N - 1; ++p)
+        {
+            for (int q = p + 1; q < N; ++q)
+            {
+                const double apq = a[q][p];
+                // Skip rotations that would not change the diagonal
+                if (std::abs(apq) <=
+                    eps * std::sqrt(std::abs(a[p][p] * a[q][q])))
+                {
+                    a[q][p] = 0.0;
+                    a[p][q] = 0.0;
+                    continue;
+                }
+
+                // Rotation angle (Rutishauser's formulation)
+                const double theta = (a[q][q] - a[p][p]) / (2.0 * apq);
+                const double t =
+                    (theta >= 0 ? 1.0 : -1.0) /
+                    (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+
+                // A = J' A J, applied to columns p and q, then rows p and q
+                double *ap = a[p];
+                double *aq = a[q];
+#pragma omp simd
+                for (int k = 0; k < N; ++k)
+                {
+                    const double akp = ap[k];
+                    const double akq = aq[k];
+                    ap[k] = c * akp - s * akq;
+                    aq[k] = s * akp + c * akq;
+                }
+                Unroll<0, N>::run([&](int k) {
+                    const double apk = a[k][p];
+                    const double aqk = a[k][q];
+                    a[k][p] = c * apk - s * aqk;
+                    a[k][q] = s * apk + c * aqk;
+                });
+                a[q][p] = 0.0;
+                a[p][q] = 0.0;
+
+                double *vp = vt[p];
+                double *vq = vt[q];
+#pragma omp simd
+                for (int k = 0; k < N; ++k)
+                {
+                    const double vkp = vp[k];
+                    const double vkq = vq[k];
+                    vp[k] = c * vkp - s * vkq;
+                    vq[k] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Reduce the symmetric matrix a, stored by columns with both
+ * triangles, to tridiagonal form T = Q' A Q by Householder reflections.
+ *
+ * On exit d holds the diagonal of T, e[i] the element T(i + 1, i) (with
+ * e[N - 1] = 0), and the columns qt[j] hold Q. a is destroyed.
+ */
+template <int N>
+inline void tridiagonalize(double (&a)[N][N], double (&qt)[N][N],
+                           double (&d)[N], double (&e)[N])
+{
+    double tau[N] = {};
+    double w[N];
+    for (int k = 0; k < N - 2; ++k)
+    {
+        // Reflect x = A(k+1:N, k) onto beta * e_1, with the reflector
+        // I - tau v v' and v = (1, x(2:) / (alpha - beta)) as in dlarfg
+        double *x = a[k];
+        d[k] = x[k];
+        double tail = 0.0;
+#pragma omp simd reduction(+ : tail)
+        for (int i = k + 2; i < N; ++i)
+            tail += x[i] * x[i];
+        if (tail == 0.0)
+        {
+            e[k] = x[k + 1];
+            continue;
+        }
+        const double alpha = x[k + 1];
+        double beta = std::sqrt(alpha * alpha + tail);
+        if (alpha > 0.0)
+            beta = -beta;
+        tau[k] = (beta - alpha) / beta;
+        const double scale = 1.0 / (alpha - beta);
+        x[k + 1] = 1.0;
+#pragma omp simd
+        for (int i = k + 2; i < N; ++i)
+            x[i] *= scale;
+        e[k] = beta;
+
+        // A22 -= v w' + w v' with w = p - (tau/2)(p'v) v, p = tau A22 v
+        for (int i = k + 1; i < N; ++i)
+            w[i] = 0.0;
+        for (int j = k + 1; j < N; ++j)
+        {
+            const double vj = tau[k] * x[j];
+            const double *aj = a[j];
+#pragma omp simd
+            for (int i = k + 1; i < N; ++i)
+                w[i] += vj * aj[i];
+        }
+        double pv = 0.0;
+#pragma omp simd reduction(+ : pv)
+        for (int i = k + 1; i < N; ++i)
+            pv += w[i] * x[i];
+        const double half = 0.5 * tau[k] * pv;
+#pragma omp simd
+        for (int i = k + 1; i < N; ++i)
+            w[i] -= half * x[i];
+        for (int j = k + 1; j < N; ++j)
+        {
+            const double vj = x[j];
+            const double wj = w[j];
+            double *aj = a[j];
+#pragma omp simd
+            for (int i = k + 1; i < N; ++i)
+                aj[i] -= x[i] * wj + w[i] * vj;
+        }
+    }
+    d[N - 2] = a[N - 2][N - 2];
+    e[N - 2] = a[N - 2][N - 1];
+    d[N - 1] = a[N - 1][N - 1];
+    e[N - 1] = 0.0;
+
+    // Q = H(0) H(1) ... H(N-3), applied to the identity from the right end
+    for (int j = 0; j < N; ++j)
+        for (int i = 0; i < N; ++i)
+            qt[j][i] = (i == j) ? 1.0 : 0.0;
+    for (int k = N - 3; k >= 0; --k)
+    {
+        if (tau[k] == 0.0)
+            continue;
+        const double *x = a[k];
+        for (int j = k + 1; j < N; ++j)
+        {
+            double *qj = qt[j];
+            double g = 0.0;
+#pragma omp simd reduction(+ : g)
+            for (int i = k + 1; i < N; ++i)
+                g += x[i] * qj[i];
+            g *= tau[k];
+#pragma omp simd
+            for (int i = k + 1; i < N; ++i)
+                qj[i] -= g * x[i];
+        }
+    }
+}
+
+/**
+ * @brief The implicit QL iteration with Wilkinson shifts on the symmetric
+ * tridiagonal matrix (d, e) from `tridiagonalize`, applying the rotations
+ * to the columns zt[j] of Z.
+ *
+ * On exit d holds the eigenvalues, unsorted, and Z the eigenvectors.
+ *
+ * @return false if the iteration did not converge.
+ */
+template <int N>
+inline bool tridiagonal_ql(double (&d)[N], double (&e)[N],
+                           double (&zt)[N][N])
+{
+    const double eps = std::numeric_limits<double>::epsilon();
+    const int max_iter = 30 * N;
+    int iter = 0;
+    double f = 0.0;
+    double tst1 = 0.0;
+    for (int l = 0; l < N; ++l)
+    {
+        // Find a small subdiagonal element; e[N - 1] is zero
+        tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+        int m = l;
+        while (m < N - 1 && std::abs(e[m]) > eps * tst1)
+            ++m;
+
+        while (m > l)
+        {
+            if (++iter > max_iter)
+                return false;
+
+            // Shift from the leading 2x2 block
+            double g = d[l];
+            double p = (d[l + 1] - g) / (2.0 * e[l]);
+            double r = hypot(p, 1.0);
+            if (p < 0)
+                r = -r;
+            d[l] = e[l] / (p + r);
+            d[l + 1] = e[l] * (p + r);
+            const double dl1 = d[l + 1];
+            double h = g - d[l];
+            for (int i = l + 2; i < N; ++i)
+                d[i] -= h;
+            f += h;
+
+            // Implicit QL transformation
+            p = d[m];
+            double c = 1.0;
+            double c2 = c;
+            double c3 = c;
+            const double el1 = e[l + 1];
+            double s = 0.0;
+            double s2 = 0.0;
+            for (int i = m - 1; i >= l; --i)
+            {
+                c3 = c2;
+                c2 = c;
+                s2 = s;
+                g = c * e[i];
+                h = c * p;
+                r = hypot(p, e[i]);
+                e[i + 1] = s * r;
+                s = e[i] / r;
+                c = p / r;
+                p = c * d[i] - s * g;
+                d[i + 1] = h + s * (c * g + s * d[i]);
+
+                double *z0 = zt[i];
+                double *z1 = zt[i + 1];
+#pragma omp simd
+                for (int k = 0; k < N; ++k)
+                {
+                    const double zk = z1[k];
+                    z1[k] = s * z0[k] + c * zk;
+                    z0[k] = c * z0[k] - s * zk;
+                }
+            }
+            p = -s * s2 * c3 * el1 * e[l] / dl1;
+            e[l] = s * p;
+            d[l] = c * p;
+            if (std::abs(e[l]) <= eps * tst1)
+                break;
+        }
+        d[l] += f;
+        e[l] = 0.0;
+    }
+    return true;
+}
+
+/**
+ * @brief Copy the upper triangle of a symmetric A into both triangles of a,
+ * stored by columns: a[j][i] = A(i, j).
+ */
+template <int N>
+inline void load_symmetric(const Eigen::Matrix<double, N, N> &A,
+                           double (&a)[N][N])
+{
+    for (int j = 0; j < N; ++j)
+        for (int i = 0; i < N; ++i)
+            a[j][i] = (i <= j) ? A.coeff(i, j) : A.coeff(j, i);
+}
+
+/**
+ * @brief Store the eigenvalues d in ascending order in W and the matching
+ * columns vt[j] in V.
+ */
+template <int N>
+inline void store_sorted(const double (&d)[N], const double (&vt)[N][N],
+                         Eigen::Matrix<double, N, 1> &W,
+                         Eigen::Matrix<double, N, N> &V)
+{
+    // Selection sort, N is small
+    int order[N];
+    for (int i = 0; i < N; ++i)
+        order[i] = i;
+    for (int i = 0; i < N - 1; ++i)
+    {
+        int k = i;
+        for (int j = i + 1; j < N; ++j)
+            if (d[order[j]] < d[order[k]])
+                k = j;
+        std::swap(order[i], order[k]);
+    }
+
+    for (int j = 0; j < N; ++j)
+    {
+        W.coeffRef(j) = d[order[j]];
+        for (int i = 0; i < N; ++i)
+            V.coeffRef(i, j) = vt[order[j]][i];
+    }
+}
+
+} // namespace fixed_detail
+
+/**
+ * @brief Compute the eigenvalues and eigenvectors of a fixed-size real matrix.
+ *
+ * The result follows LAPACK's `dgeev` convention: eigenvalue j is
+ * WR(j) + i*WI(j); complex conjugate pairs are consecutive with WI(j) > 0,
+ * and their eigenvector is V(:,j) +- i*V(:,j+1). Eigenvectors are normalized
+ * to unit Euclidean norm.
+ *
+ * @tparam N The order of the matrix, intended for 5 <= N <= 32.
+ * @param A The input matrix.
+ * @param WR The vector that will store the real parts of the eigenvalues.
+ * @param WI The vector that will store the imaginary parts of the eigenvalues.
+ * @param V The matrix that will store the eigenvectors.
+ */
+template <int N>
+void fixed_eigen_decomposition(const Eigen::Matrix<double, N, N> &A,
+                               Eigen::Matrix<double, N, 1> &WR,
+                               Eigen::Matrix<double, N, 1> &WI,
+                               Eigen::Matrix<double, N, N> &V)
+{
+    static_assert(N >= 2 && N <= 32,
+                  "fixed_eigen_decomposition supports 2 <= N <= 32");
+
+    double H[N][N];
+    double Q[N][N]; // by columns, Q[j][i] = V(i, j)
+    double wr[N];
+    double wi[N];
+    for (int j = 0; j < N; ++j)
+        for (int i = 0; i < N; ++i)
+            H[i][j] = A.coeff(i, j);
+
+    fixed_detail::hessenberg<N>(H, Q);
+    if (!fixed_detail::francis_qr<N>(H, Q, wr, wi))
+    {
+        throw std::runtime_error(
+            "fixed_eigen_decomposition: QR iteration did not converge");
+    }
+    fixed_detail::normalize_eigenvectors<N>(Q, wi);
+
+    for (int j = 0; j < N; ++j)
+    {
+        WR.coeffRef(j) = wr[j];
+        WI.coeffRef(j) = wi[j];
+        for (int i = 0; i < N; ++i)
+            V.coeffRef(i, j) = Q[j][i];
+    }
+}
+
+/**
+ * @brief Compute the eigen decomposition of a fixed-size real matrix,
+ * returning only the real parts of the eigenvalues like
+ * `eigen_decomposition`.
+ *
+ * @tparam N The order of the matrix, intended for 5 <= N <= 32.
+ * @param A The input matrix.
+ * @param W The vector that will store the (real parts of the) eigenvalues.
+ * @param V The matrix that will store the eigenvectors.
+ */
+template <int N>
+void fixed_eigen_decomposition(const Eigen::Matrix<double, N, N> &A,
+                               Eigen::Matrix<double, N, 1> &W,
+                               Eigen::Matrix<double, N, N> &V)
+{
+    Eigen::Matrix<double, N, 1> WI;
+    fixed_eigen_decomposition<N>(A, W, WI, V);
+}
+
+/**
+ * @brief Compute the eigenvalues and eigenvectors of a fixed-size symmetric
+ * matrix by tridiagonal QL.
+ *
+ * Only the upper triangle of A is referenced. The eigenvalues are returned in
+ * ascending order and V is orthogonal. A is reduced to tridiagonal form by
+ * Householder reflections, which is then diagonalized by the implicit QL
+ * iteration with Wilkinson shifts. This is faster than
+ * `fixed_jacobi_eigen_decomposition` at every N and than `dsyevr` through
+ * LAPACK up to N = 32.
+ *
+ * @tparam N The order of the matrix, intended for 5 <= N <= 32.
+ * @param A The symmetric input matrix.
+ * @param W The vector that will store the eigenvalues, ascending.
+ * @param V The matrix that will store the orthonormal eigenvectors.
+ */
+template <int N>
+void fixed_symmetric_eigen_decomposition(const Eigen::Matrix<double, N, N> &A,
+                                         Eigen::Matrix<double, N, 1> &W,
+                                         Eigen::Matrix<double, N, N> &V)
+{
+    static_assert(N >= 2 && N <= 32,
+                  "fixed_symmetric_eigen_decomposition supports 2 <= N <= 32");
+    double a[N][N];
+    double v[N][N];
+    double d[N];
+    double e[N];
+    fixed_detail::load_symmetric<N>(A, a);
+    fixed_detail::tridiagonalize<N>(a, v, d, e);
+    if (!fixed_detail::tridiagonal_ql<N>(d, e, v))
+    {
+        throw std::runtime_error("fixed_symmetric_eigen_decomposition: QL "
+                                 "iteration did not converge");
+    }
+    fixed_detail::store_sorted<N>(d, v, W, V);
+}
+
+/**
+ * @brief Compute the eigenvalues and eigenvectors of a fixed-size symmetric
+ * matrix with the cyclic Jacobi method.
+ *
+ * Same contract as `fixed_symmetric_eigen_decomposition`, which is faster;
+ * Jacobi is kept for its accuracy: it finds small eigenvalues of graded
+ * matrices to high relative accuracy, where tridiagonal QL only guarantees
+ * an absolute error of order eps * ||A||.
+ *
+ * @tparam N The order of the matrix, intended for 5 <= N <= 32.
+ * @param A The symmetric input matrix.
+ * @param W The vector that will store the eigenvalues, ascending.
+ * @param V The matrix that will store the orthonormal eigenvectors.
+ */
+template <int N>
+void fixed_jacobi_eigen_decomposition(const Eigen::Matrix<double, N, N> &A,
+                                      Eigen::Matrix<double, N, 1> &W,
+                                      Eigen::Matrix<double, N, N> &V)
+{
+    static_assert(N >= 2 && N <= 32,
+                  "fixed_jacobi_eigen_decomposition supports 2 <= N <= 32");
+    double a[N][N];
+    double v[N][N];
+    double d[N];
+    fixed_detail::load_symmetric<N>(A, a);
+    for (int j = 0; j < N; ++j)
+        for (int i = 0; i < N; ++i)
+            v[j][i] = (i == j) ? 1.0 : 0.0;
+    if (!fixed_detail::jacobi<N>(a, v))
+    {
+        throw std::runtime_error(
+            "fixed_jacobi_eigen_decomposition: Jacobi did not converge");
+    }
+    for (int i = 0; i < N; ++i)
+        d[i] = a[i][i];
+    fixed_detail::store_sorted<N>(d, v, W, V);
+}
+
+#endif // FIXED_SIZE_EIGEN_H
@@ -0,0 +1,306 @@
+/**
+ * @file fortran_eigen_solver.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines `FortranEigenSolver`, a drop-in
+ * replacement for `Eigen::EigenSolver` backed by the Fortran LAPACK
+ * bindings.
+ *
+ * The class mirrors the interface of `Eigen::EigenSolver` (size
+ * preallocation, `compute()`, `eigenvalues()`, `eigenvectors()`, `info()`),
+ * so code written against Eigen's solver can switch to the LAPACK backend by
+ * changing the type. Unlike the free function `eigen_decomposition`, the
+ * solver owns all of its buffers, including the LAPACK workspace: once sized,
+ * repeated `compute()` calls at the same size do not allocate. Like
+ * `eigen_decomposition` it dispatches on the structure of the matrix (see
+ * `eigen_interface_detail::solve_eigen`), so `dgeev` only sees general
+ * matrices.
+ */
+
+#ifndef FORTRAN_EIGEN_SOLVER_H
+#define FORTRAN_EIGEN_SOLVER_H
+
+#include "eigen_interface.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Eigen decomposition of a real matrix through LAPACK.
+ *
+ * @tparam MatrixType_ The type of the matrix, e.g. `Eigen::MatrixXd`. Only
+ * double precision is supported.
+ */
+template <typename MatrixType_>
+class FortranEigenSolver
+{
+  public:
+    using MatrixType = MatrixType_;
+    using Scalar = typename MatrixType::Scalar;
+    using Index = Eigen::Index;
+    using ComplexScalar = std::complex<Scalar>;
+
+    static_assert(std::is_same<Scalar, double>::value,
+                  "FortranEigenSolver only supports double precision");
+
+    enum
+    {
+        RowsAtCompileTime = MatrixType::RowsAtCompileTime,
+        ColsAtCompileTime = MatrixType::ColsAtCompileTime,
+        MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+        MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime
+    };
+
+    /** Column-major working matrix, whatever the storage order of the input. */
+    using WorkMatrixType =
+        Eigen::Matrix<Scalar, RowsAtCompileTime, ColsAtCompileTime,
+                      Eigen::ColMajor, MaxRowsAtCompileTime,
+                      MaxColsAtCompileTime>;
+    using RealVectorType = Eigen::Matrix<Scalar, ColsAtCompileTime, 1,
+                                         Eigen::ColMajor, MaxColsAtCompileTime,
+                                         1>;
+    using EigenvalueType =
+        Eigen::Matrix<ComplexScalar, ColsAtCompileTime, 1, Eigen::ColMajor,
+                      MaxColsAtCompileTime, 1>;
+    using EigenvectorsType =
+        Eigen::Matrix<ComplexScalar, RowsAtCompileTime, ColsAtCompileTime,
+                      Eigen::ColMajor, MaxRowsAtCompileTime,
+                      MaxColsAtCompileTime>;
+
+    /**
+     * @brief Default constructor; buffers are allocated by the first
+     * `compute()`.
+     */
+    FortranEigenSolver() = default;
+
+    /**
+     * @brief Preallocate all buffers for matrices of the given size.
+     *
+     * @param size The order of the matrices to be decomposed.
+     */
+    explicit FortranEigenSolver(Index size)
+    {
+        allocate(size, true);
+    }
+
+    /**
+     * @brief Compute the eigen decomposition of A.
+     *
+     * @param A The square input matrix (any Eigen expression).
+     * @param computeEigenvectors Whether the eigenvectors are computed.
+     */
+    template <typename InputType>
+    explicit FortranEigenSolver(const Eigen::EigenBase<InputType> &A,
+                                bool computeEigenvectors = true)
+    {
+        compute(A.derived(), computeEigenvectors);
+    }
+
+    /**
+     * @brief Compute the eigen decomposition of A.
+     *
+     * A is evaluated once, directly into the solver's working matrix, which
+     * LAPACK then overwrites. If A has the same size as in the previous
+     * call, no memory is allocated.
+     *
+     * @param A The square input matrix (any Eigen expression).
+     * @param computeEigenvectors Whether the eigenvectors are computed.
+     * @return A reference to *this.
+     */
+    template <typename InputType>
+    FortranEigenSolver &compute(const Eigen::EigenBase<InputType> &A,
+                                bool computeEigenvectors = true)
+    {
+        eigen_assert(A.rows() == A.cols());
+        const Index n = A.rows();
+        allocate(n, computeEigenvectors);
+        evaluate_into(m_matrix, A.derived());
+
+        eigen_interface_detail::EigenWorkspace ws;
+        ws.work = m_work.data();
+        ws.lwork = static_cast<lapack_int>(m_work.size());
+        ws.iwork = m_iwork.data();
+        ws.liwork = static_cast<lapack_int>(m_iwork.size());
+        try
+        {
+            eigen_interface_detail::solve_eigen(
+                static_cast<lapack_int>(n), m_matrix.data(),
+                std::max<lapack_int>(1, n), computeEigenvectors ? 'V' : 'N',
+                m_wr.data(), m_wi.data(),
+                computeEigenvectors ? m_pseudo.data() : &m_unused,
+                std::max<lapack_int>(1, n), ws);
+            m_info = Eigen::Success;
+        }
+        catch (const std::invalid_argument &)
+        {
+            m_info = Eigen::InvalidInput;
+        }
+        catch (const std::runtime_error &)
+        {
+            m_info = Eigen::NoConvergence;
+        }
+        m_isInitialized = true;
+        m_eigenvectorsOk = computeEigenvectors && m_info == Eigen::Success;
+        if (m_info != Eigen::Success)
+            return *this;
+
+        for (Index j = 0; j < n; ++j)
+            m_eivalues(j) = ComplexScalar(m_wr(j), m_wi(j));
+
+        if (computeEigenvectors)
+        {
+            // dgeev stores a complex pair as two real columns (re, im)
+            for (Index j = 0; j < n; ++j)
+            {
+                if (m_wi(j) == 0.0 || j + 1 == n)
+                {
+                    m_eivec.col(j) =
+                        m_pseudo.col(j).template cast<ComplexScalar>();
+                }
+                else
+                {
+                    for (Index i = 0; i < n; ++i)
+                    {
+                        m_eivec(i, j) =
+                            ComplexScalar(m_pseudo(i, j), m_pseudo(i, j + 1));
+                        m_eivec(i, j + 1) = std::conj(m_eivec(i, j));
+                    }
+                    ++j;
+                }
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief The eigenvalues, in the order computed by LAPACK.
+     */
+    const EigenvalueType &eigenvalues() const
+    {
+        eigen_assert(m_isInitialized &&
+                     "FortranEigenSolver is not initialized.");
+        return m_eivalues;
+    }
+
+    /**
+     * @brief The (complex) eigenvectors, normalized to unit 2-norm.
+     *
+     * In contrast to `Eigen::EigenSolver`, this returns a reference to a
+     * buffer filled by `compute()` rather than building a new matrix.
+     */
+    const EigenvectorsType &eigenvectors() const
+    {
+        eigen_assert(m_isInitialized &&
+                     "FortranEigenSolver is not initialized.");
+        eigen_assert(m_eigenvectorsOk &&
+                     "The eigenvectors have not been computed together with "
+                     "the eigenvalues.");
+        return m_eivec;
+    }
+
+    /**
+     * @brief The real eigenvector matrix in LAPACK's layout: a complex pair
+     * occupies two consecutive columns holding its real and imaginary part.
+     */
+    const WorkMatrixType &pseudoEigenvectors() const
+    {
+        eigen_assert(m_isInitialized &&
+                     "FortranEigenSolver is not initialized.");
+        eigen_assert(m_eigenvectorsOk &&
+                     "The eigenvectors have not been computed together with "
+                     "the eigenvalues.");
+        return m_pseudo;
+    }
+
+    /**
+     * @brief Reports whether the last computation was successful.
+     *
+     * @return `Eigen::Success`, `Eigen::NoConvergence` (LAPACK failed) or
+     * `Eigen::InvalidInput` (the matrix holds NaN or Inf).
+     */
+    Eigen::ComputationInfo info() const
+    {
+        eigen_assert(m_isInitialized &&
+                     "FortranEigenSolver is not initialized.");
+        return m_info;
+    }
+
+  private:
+    /**
+     * @brief Evaluate an expression into the working matrix, already sized
+     * by `allocate`, without a temporary.
+     *
+     * Plain matrices go through the conversion kernels, as in
+     * `eigen_decomposition`; other expressions are written straight into
+     * dst by Eigen (products without a temporary).
+     */
+    template <typename Derived>
+    static void evaluate_into(WorkMatrixType &dst,
+                              const Eigen::MatrixBase<Derived> &src)
+    {
+        if constexpr (eigen_interface_detail::direct_layout<Derived>)
+            eigen_interface_detail::load_matrix(
+                src, dst.data(), std::max<lapack_int>(1, dst.rows()));
+        else
+            dst.noalias() = src;
+    }
+
+    template <typename Derived>
+    static void evaluate_into(WorkMatrixType &dst,
+                              const Eigen::EigenBase<Derived> &src)
+    {
+        dst = src.derived();
+    }
+
+    /**
+     * @brief Size all buffers for order n; a no-op if they already fit.
+     *
+     * @throws std::runtime_error if the workspace query fails.
+     */
+    void allocate(Index n, bool computeEigenvectors)
+    {
+        const char job = computeEigenvectors ? 'V' : 'N';
+        if (n != m_n || job != m_job)
+        {
+            lapack_int lwork = 1;
+            lapack_int liwork = 1;
+            eigen_interface_detail::solve_eigen_workspace(
+                static_cast<lapack_int>(n), job, &lwork, &liwork);
+            if (static_cast<std::size_t>(lwork) > m_work.size())
+                m_work.resize(lwork);
+            if (static_cast<std::size_t>(liwork) > m_iwork.size())
+                m_iwork.resize(liwork);
+            m_n = n;
+            m_job = job;
+        }
+        m_matrix.resize(n, n);
+        m_wr.resize(n);
+        m_wi.resize(n);
+        m_eivalues.resize(n);
+        if (computeEigenvectors)
+        {
+            m_pseudo.resize(n, n);
+            m_eivec.resize(n, n);
+        }
+    }
+
+    WorkMatrixType m_matrix;
+    WorkMatrixType m_pseudo;
+    RealVectorType m_wr;
+    RealVectorType m_wi;
+    EigenvalueType m_eivalues;
+    EigenvectorsType m_eivec;
+    std::vector<double> m_work;
+    std::vector<lapack_int> m_iwork;
+    Index m_n = -1;
+    char m_job = 0;
+    double m_unused = 0.0; // V argument of LAPACK when it is not referenced
+    Eigen::ComputationInfo m_info = Eigen::Success;
+    bool m_isInitialized = false;
+    bool m_eigenvectorsOk = false;
+};
+
+#endif // FORTRAN_EIGEN_SOLVER_H
@@ -0,0 +1,399 @@
+/**
+ * @file io_engine.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the io_uring and synchronous
+ * I/O engines.
+ *
+ * The io_uring engine maps the submission and completion rings itself. It
+ * is their only user: the submission tail and the completion head are
+ * written by this thread alone, and only the kernel's side of each ring
+ * needs acquire/release ordering. Every request is submitted right away
+ * with one io_uring_enter(), so submission entries never pile up; at most
+ * depth requests are in flight, which keeps the completion ring (twice that
+ * size) from overflowing.
+ */
+
+#include "io_engine.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <stdexcept>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+
+[[noreturn]] void fail(const std::string &what, int error)
+{
+    throw std::runtime_error(what + ": " + std::strerror(error));
+}
+
+class SyncEngine : public IoEngine
+{
+  public:
+    const char *name() const override
+    {
+        return "sync";
+    }
+
+    bool register_buffers(const std::vector<iovec> &) override
+    {
+        return true;
+    }
+
+    void read(int fd, void *data, std::size_t bytes, off_t offset, int,
+              std::uint64_t tag) override
+    {
+        std::size_t done = 0;
+        while (done < bytes)
+        {
+            const ssize_t got = pread(fd, static_cast<char *>(data) + done,
+                                      bytes - done, offset + done);
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got < 0)
+                fail("read failed", errno);
+            if (got == 0)
+                break;
+            done += got;
+        }
+        completed_.push_back({tag, done});
+    }
+
+    void write(int fd, const void *data, std::size_t bytes, off_t offset,
+               int, std::uint64_t tag) override
+    {
+        std::size_t done = 0;
+        while (done < bytes)
+        {
+            const ssize_t put =
+                pwrite(fd, static_cast<const char *>(data) + done,
+                       bytes - done, offset + done);
+            if (put < 0 && errno == EINTR)
+                continue;
+            if (put < 0)
+                fail("write failed", errno);
+            done += put;
+        }
+        completed_.push_back({tag, done});
+    }
+
+    std::size_t pending() const override
+    {
+        return completed_.size();
+    }
+
+    IoCompletion wait() override
+    {
+        if (completed_.empty())
+            throw std::logic_error("IoEngine::wait: no pending request");
+        const IoCompletion completion = completed_.front();
+        completed_.pop_front();
+        return completion;
+    }
+
+  private:
+    std::deque<IoCompletion> completed_;
+};
+
+#ifdef __linux__
+
+class UringEngine : public IoEngine
+{
+  public:
+    explicit UringEngine(unsigned depth) : depth_(depth)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof params);
+        fd_ = static_cast<int>(
+            syscall(__NR_io_uring_setup, depth, &params));
+        if (fd_ < 0)
+            fail("io_uring_setup failed", errno);
+
+        sq_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes_ =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single)
+            sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+        sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+
+        sq_ = map(sq_bytes_, IORING_OFF_SQ_RING);
+        cq_ = single ? sq_ : map(cq_bytes_, IORING_OFF_CQ_RING);
+        sqes_ = static_cast<io_uring_sqe *>(
+            map(sqes_bytes_, IORING_OFF_SQES));
+
+        char *sq = static_cast<char *>(sq_);
+        sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        char *cq = static_cast<char *>(cq_);
+        cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    }
+
+    ~UringEngine() override
+    {
+        // Requests still in flight would write into buffers the caller is
+        // about to free
+        while (!requests_.empty())
+        {
+            try
+            {
+                reap();
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+        release();
+    }
+
+    UringEngine(const UringEngine &) = delete;
+    UringEngine &operator=(const UringEngine &) = delete;
+
+    const char *name() const override
+    {
+        return "uring";
+    }
+
+    bool register_buffers(const std::vector<iovec> &buffers) override
+    {
+        registered_ = syscall(__NR_io_uring_register, fd_,
+                              IORING_REGISTER_BUFFERS, buffers.data(),
+                              static_cast<unsigned>(buffers.size())) == 0;
+        return registered_;
+    }
+
+    void read(int fd, void *data, std::size_t bytes, off_t offset, int buffer,
+              std::uint64_t tag) override
+    {
+        start({fd, true, static_cast<char *>(data), bytes, offset, buffer},
+              tag);
+    }
+
+    void write(int fd, const void *data, std::size_t bytes, off_t offset,
+               int buffer, std::uint64_t tag) override
+    {
+        start({fd, false,
+               const_cast<char *>(static_cast<const char *>(data)), bytes,
+               offset, buffer},
+              tag);
+    }
+
+    std::size_t pending() const override
+    {
+        return requests_.size() + completed_.size();
+    }
+
+    IoCompletion wait() override
+    {
+        while (completed_.empty())
+        {
+            if (requests_.empty())
+                throw std::logic_error("IoEngine::wait: no pending request");
+            reap();
+        }
+        const IoCompletion completion = completed_.front();
+        completed_.pop_front();
+        return completion;
+    }
+
+  private:
+    struct Request
+    {
+        int fd;
+        bool read;
+        char *data;
+        std::size_t remaining;
+        off_t offset;
+        int buffer;
+        std::size_t done = 0;
+        iovec iov = {};
+    };
+
+    void release()
+    {
+        if (sqes_ != nullptr)
+            munmap(sqes_, sqes_bytes_);
+        if (cq_ != nullptr && cq_ != sq_)
+            munmap(cq_, cq_bytes_);
+        if (sq_ != nullptr)
+            munmap(sq_, sq_bytes_);
+        if (fd_ >= 0)
+            close(fd_);
+    }
+
+    void *map(std::size_t bytes, off_t offset)
+    {
+        void *ring = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, fd_, offset);
+        if (ring == MAP_FAILED)
+        {
+            const int error = errno;
+            release();
+            fail("cannot map the io_uring rings", error);
+        }
+        return ring;
+    }
+
+    void start(const Request &request, std::uint64_t tag)
+    {
+        if (requests_.count(tag) != 0)
+            throw std::logic_error("IoEngine: tag is already pending");
+        // Keep the completion ring from overflowing
+        while (requests_.size() >= depth_)
+            reap();
+        Request &r = requests_.emplace(tag, request).first->second;
+        try
+        {
+            submit(r, tag);
+        }
+        catch (...)
+        {
+            requests_.erase(tag);
+            throw;
+        }
+    }
+
+    void submit(Request &r, std::uint64_t tag)
+    {
+        const unsigned tail = *sq_tail_;
+        const unsigned index = tail & sq_mask_;
+        io_uring_sqe &sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof sqe);
+        // One request moves at most 1 GiB; the rest is resubmitted
+        const std::size_t chunk =
+            std::min<std::size_t>(r.remaining, std::size_t(1) << 30);
+        sqe.fd = r.fd;
+        sqe.off = static_cast<std::uint64_t>(r.offset);
+        sqe.user_data = tag;
+        if (registered_ && r.buffer >= 0)
+        {
+            sqe.opcode = r.read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+            sqe.addr = reinterpret_cast<std::uint64_t>(r.data);
+            sqe.len = static_cast<std::uint32_t>(chunk);
+            sqe.buf_index = static_cast<std::uint16_t>(r.buffer);
+        }
+        else
+        {
+            r.iov = {r.data, chunk};
+            sqe.opcode = r.read ? IORING_OP_READV : IORING_OP_WRITEV;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&r.iov);
+            sqe.len = 1;
+        }
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+        while (syscall(__NR_io_uring_enter, fd_, 1, 0, 0, nullptr, 0) < 0)
+        {
+            if (errno != EINTR)
+                fail("io_uring_enter failed", errno);
+        }
+    }
+
+    void reap()
+    {
+        unsigned head = *cq_head_;
+        while (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+        {
+            if (syscall(__NR_io_uring_enter, fd_, 0, 1,
+                        IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR)
+                fail("io_uring_enter failed", errno);
+        }
+        const io_uring_cqe cqe = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+
+        const auto found = requests_.find(cqe.user_data);
+        if (found == requests_.end())
+            return;
+        Request &r = found->second;
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+        {
+            submit(r, cqe.user_data);
+            return;
+        }
+        const char *what = r.read ? "read failed" : "write failed";
+        if (cqe.res < 0)
+        {
+            requests_.erase(found);
+            fail(what, -cqe.res);
+        }
+        const std::size_t moved = static_cast<std::size_t>(cqe.res);
+        r.done += moved;
+        r.data += moved;
+        r.offset += moved;
+        r.remaining -= moved;
+        if (moved == 0 || r.remaining == 0)
+        {
+            const std::size_t done = r.done;
+            const bool short_write = moved == 0 && !r.read;
+            requests_.erase(found);
+            if (short_write)
+                fail(what, EIO);
+            completed_.push_back({cqe.user_data, done});
+            return;
+        }
+        submit(r, cqe.user_data);
+    }
+
+    unsigned depth_;
+    int fd_ = -1;
+    bool registered_ = false;
+    void *sq_ = nullptr;
+    void *cq_ = nullptr;
+    io_uring_sqe *sqes_ = nullptr;
+    std::size_t sq_bytes_ = 0;
+    std::size_t cq_bytes_ = 0;
+    std::size_t sqes_bytes_ = 0;
+    unsigned *sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned *sq_array_ = nullptr;
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe *cqes_ = nullptr;
+    std::map<std::uint64_t, Request> requests_;
+    std::deque<IoCompletion> completed_;
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<IoEngine> make_io_engine(const std::string &kind,
+                                         unsigned depth)
+{
+    if (depth == 0)
+        throw std::invalid_argument("make_io_engine: depth must be positive");
+    if (kind == "sync")
+        return std::unique_ptr<IoEngine>(new SyncEngine);
+    if (kind != "uring" && kind != "auto")
+        throw std::invalid_argument("unknown I/O engine: " + kind);
+#ifdef __linux__
+    try
+    {
+        return std::unique_ptr<IoEngine>(new UringEngine(depth));
+    }
+    catch (const std::runtime_error &)
+    {
+        if (kind == "uring")
+            throw;
+    }
+#else
+    if (kind == "uring")
+        throw std::runtime_error("io_uring is only available on Linux");
+#endif
+    return std::unique_ptr<IoEngine>(new SyncEngine);
+}
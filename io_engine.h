@@ -0,0 +1,114 @@
+/**
+ * @file io_engine.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the asynchronous file I/O engines of the
+ * batch driver.
+ *
+ * Requests are submitted with a tag and finish in any order; `wait` returns
+ * the tag of a finished request. Two engines implement the interface:
+ * - "uring" uses Linux io_uring through the raw system calls (no liburing
+ *   needed). Requests run in the kernel while the caller computes, and
+ *   reads and writes into registered buffers skip the per-request page
+ *   pinning;
+ * - "sync" performs every request with pread()/pwrite() when it is
+ *   submitted, for systems without io_uring (or where containers forbid
+ *   it).
+ * Transfers that the kernel splits (e.g. above 2 GiB) are resubmitted until
+ * they are complete or reach the end of the file.
+ */
+
+#ifndef IO_ENGINE_H
+#define IO_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <vector>
+
+/**
+ * @brief A finished request.
+ */
+struct IoCompletion
+{
+    std::uint64_t tag;
+    std::size_t bytes; ///< transferred; less than requested only at EOF
+};
+
+/**
+ * @brief An asynchronous file I/O engine.
+ *
+ * Not thread-safe: one thread submits and waits.
+ */
+class IoEngine
+{
+  public:
+    virtual ~IoEngine() = default;
+
+    /**
+     * @brief "uring" or "sync".
+     */
+    virtual const char *name() const = 0;
+
+    /**
+     * @brief Register the buffers that requests will use, by index.
+     *
+     * Call once, before any request. The buffers must stay valid for the
+     * life of the engine.
+     *
+     * @return false if the engine cannot register them (e.g. over the
+     * locked-memory limit); requests still work, without the speed-up.
+     */
+    virtual bool register_buffers(const std::vector<iovec> &buffers) = 0;
+
+    /**
+     * @brief Submit a read of bytes bytes at offset of fd into data.
+     *
+     * @param buffer The index of the registered buffer that contains
+     * [data, data + bytes), or -1.
+     * @param tag Identifies the request in its completion; unique among the
+     * pending requests.
+     * @throws std::runtime_error if the request cannot be submitted.
+     */
+    virtual void read(int fd, void *data, std::size_t bytes, off_t offset,
+                      int buffer, std::uint64_t tag) = 0;
+
+    /**
+     * @brief Submit a write of bytes bytes from data at offset of fd.
+     *
+     * Parameters as for `read`.
+     */
+    virtual void write(int fd, const void *data, std::size_t bytes,
+                       off_t offset, int buffer, std::uint64_t tag) = 0;
+
+    /**
+     * @brief The number of submitted requests not yet returned by `wait`.
+     */
+    virtual std::size_t pending() const = 0;
+
+    /**
+     * @brief Wait for the next request to finish.
+     *
+     * @throws std::logic_error if no request is pending, std::runtime_error
+     * if the request failed.
+     */
+    virtual IoCompletion wait() = 0;
+};
+
+/**
+ * @brief Create an engine.
+ *
+ * @param kind "uring", "sync" or "auto" (io_uring if the kernel allows it,
+ * sync otherwise).
+ * @param depth The number of requests that may be in flight at once; more
+ * are accepted, but wait for earlier ones to finish.
+ * @throws std::invalid_argument for an unknown kind or a depth of 0,
+ * std::runtime_error if "uring" is not available.
+ */
+std::unique_ptr<IoEngine> make_io_engine(const std::string &kind,
+                                         unsigned depth);
+
+#endif // IO_ENGINE_H
@@ -0,0 +1,448 @@
+/**
+ * @file isolated_executor.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the process-isolated executor.
+ *
+ * The shared region of a worker holds, in this order, A (n x n, destroyed by
+ * LAPACK), V (n x n), and the real and imaginary parts of the eigenvalues.
+ * It only grows; the parent sends its current size with every job and the
+ * worker remaps when it changed. The worker allocates nothing but its LAPACK
+ * workspace, with plain malloc, which is safe after fork. The structure
+ * analysis, which starts threads and leases from the pool, runs in the
+ * parent; the worker gets its result with the request.
+ */
+
+#include "isolated_executor.h"
+#include "eigen_interface.h"
+#include "layout_convert.h"
+#include "structure_analyzer.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <poll.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#else
+#include <fcntl.h>
+#endif
+
+namespace
+{
+
+struct Request
+{
+    lapack_int n;
+    std::size_t region_bytes;
+    StructureProfile profile;
+};
+
+struct Reply
+{
+    bool invalid_input = false; ///< the error is a std::invalid_argument
+    char error[256] = {};       ///< empty if the decomposition succeeded
+};
+
+/**
+ * @brief Store the message of a failed decomposition in a reply.
+ */
+void set_error(Reply &reply, const std::exception &e, bool invalid_input)
+{
+    reply.invalid_input = invalid_input;
+    std::strncpy(reply.error, e.what(), sizeof reply.error - 1);
+}
+
+[[noreturn]] void fail(const std::string &what)
+{
+    throw std::runtime_error("isolated executor: " + what + " failed: " +
+                             std::strerror(errno));
+}
+
+bool read_all(int fd, void *data, std::size_t bytes)
+{
+    char *p = static_cast<char *>(data);
+    while (bytes > 0)
+    {
+        const ssize_t got = read(fd, p, bytes);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+        p += got;
+        bytes -= got;
+    }
+    return true;
+}
+
+bool send_all(int fd, const void *data, std::size_t bytes)
+{
+    const char *p = static_cast<const char *>(data);
+    while (bytes > 0)
+    {
+        const ssize_t sent = send(fd, p, bytes, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+        p += sent;
+        bytes -= sent;
+    }
+    return true;
+}
+
+/**
+ * @brief An anonymous shared memory file: memfd on Linux, an immediately
+ * unlinked POSIX shared memory object elsewhere.
+ */
+int create_shared_file()
+{
+#ifdef __linux__
+    const int fd = memfd_create("eigen_worker", MFD_CLOEXEC);
+#else
+    const std::string name =
+        "/eigen_worker_" + std::to_string(getpid()) + "_" +
+        std::to_string(reinterpret_cast<std::uintptr_t>(&name));
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+        shm_unlink(name.c_str());
+#endif
+    if (fd < 0)
+        fail("creating the shared memory file");
+    return fd;
+}
+
+/**
+ * @brief A connected pair of sockets that are closed on exec.
+ */
+void create_socket_pair(int fds[2])
+{
+#ifdef __linux__
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+        fail("socketpair");
+#else
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        fail("socketpair");
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+}
+
+/**
+ * @brief Close every descriptor above stderr except keep_a and keep_b.
+ *
+ * Runs in a freshly forked worker, so it makes nothing but system calls.
+ */
+void close_other_fds(int keep_a, int keep_b)
+{
+    const unsigned low = static_cast<unsigned>(std::min(keep_a, keep_b));
+    const unsigned high = static_cast<unsigned>(std::max(keep_a, keep_b));
+#if defined(__linux__) && defined(SYS_close_range)
+    const unsigned ranges[3][2] = {
+        {3, low - 1}, {low + 1, high - 1}, {high + 1, ~0u}};
+    bool closed = true;
+    for (const auto &range : ranges)
+    {
+        if (range[0] <= range[1] &&
+            syscall(SYS_close_range, range[0], range[1], 0) != 0)
+        {
+            closed = false;
+            break;
+        }
+    }
+    if (closed)
+        return;
+#endif
+    // Kernels without close_range: try every descriptor up to the limit
+    rlimit limit;
+    int end = 65536;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 &&
+        limit.rlim_cur != RLIM_INFINITY)
+        end = static_cast<int>(std::min<rlim_t>(limit.rlim_cur, INT_MAX));
+    for (int fd = 3; fd < end; ++fd)
+    {
+        if (static_cast<unsigned>(fd) != low &&
+            static_cast<unsigned>(fd) != high)
+            close(fd);
+    }
+}
+
+std::size_t region_doubles(lapack_int n)
+{
+    const std::size_t nn = static_cast<std::size_t>(n) * n;
+    return 2 * nn + 2 * static_cast<std::size_t>(n);
+}
+
+/**
+ * @brief The loop of a worker process: one `solve_analyzed_eigen` per
+ * request until the parent closes the socket.
+ */
+[[noreturn]] void worker_main(int socket, int memfd)
+{
+    void *region = nullptr;
+    std::size_t mapped = 0;
+    std::vector<double> work;
+    std::vector<lapack_int> iwork;
+    Request request;
+    while (read_all(socket, &request, sizeof request))
+    {
+        if (request.region_bytes != mapped)
+        {
+            if (region != nullptr)
+                munmap(region, mapped);
+            region = mmap(nullptr, request.region_bytes,
+                          PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+            if (region == MAP_FAILED)
+                _exit(1);
+            mapped = request.region_bytes;
+        }
+        const lapack_int n = request.n;
+        const std::size_t nn = static_cast<std::size_t>(n) * n;
+        double *a = static_cast<double *>(region);
+        double *v = a + nn;
+        double *wr = v + nn;
+        double *wi = wr + n;
+
+        Reply reply;
+        try
+        {
+            eigen_interface_detail::EigenWorkspace ws;
+            eigen_interface_detail::solve_eigen_workspace(n, 'V', &ws.lwork,
+                                                          &ws.liwork);
+            work.resize(std::max<lapack_int>(1, ws.lwork));
+            iwork.resize(std::max<lapack_int>(1, ws.liwork));
+            ws.work = work.data();
+            ws.iwork = iwork.data();
+            eigen_interface_detail::solve_analyzed_eigen(
+                request.profile, n, a, std::max<lapack_int>(1, n), 'V', wr,
+                wi, v, std::max<lapack_int>(1, n), ws);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            set_error(reply, e, true);
+        }
+        catch (const std::exception &e)
+        {
+            set_error(reply, e, false);
+        }
+        if (!send_all(socket, &reply, sizeof reply))
+            break;
+    }
+    _exit(0);
+}
+
+} // namespace
+
+IsolatedExecutor::IsolatedExecutor(unsigned workers)
+    : workers_(std::max(1u, workers))
+{
+    try
+    {
+        for (Worker &w : workers_)
+        {
+            w.memfd = create_shared_file();
+            spawn(w);
+            idle_.push_back(&w);
+        }
+    }
+    catch (...)
+    {
+        shutdown();
+        throw;
+    }
+}
+
+IsolatedExecutor::~IsolatedExecutor()
+{
+    shutdown();
+}
+
+void IsolatedExecutor::shutdown()
+{
+    for (Worker &w : workers_)
+    {
+        if (w.socket >= 0)
+            close(w.socket); // the worker sees EOF and exits
+        if (w.pid > 0)
+            waitpid(w.pid, nullptr, 0);
+        if (w.region != nullptr)
+            munmap(w.region, w.region_bytes);
+        if (w.memfd >= 0)
+            close(w.memfd);
+        w = Worker();
+    }
+}
+
+void IsolatedExecutor::spawn(Worker &worker)
+{
+    // One spawn at a time, so that no worker is forked while another
+    // spawn's socket pair is open in the parent
+    std::lock_guard<std::mutex> lock(mutex_);
+    int fds[2];
+    create_socket_pair(fds);
+    const pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        fail("fork");
+    }
+    if (pid == 0)
+    {
+        // Only the parent may hold the other workers' sockets, or their
+        // deaths would go unnoticed; the host's descriptors have no
+        // business in the worker either
+        close_other_fds(fds[1], worker.memfd);
+        worker_main(fds[1], worker.memfd);
+    }
+    close(fds[1]);
+    worker.pid = pid;
+    worker.socket = fds[0];
+}
+
+void IsolatedExecutor::kill_worker(Worker &worker)
+{
+    if (worker.pid > 0)
+    {
+        kill(worker.pid, SIGKILL);
+        waitpid(worker.pid, nullptr, 0);
+    }
+    if (worker.socket >= 0)
+        close(worker.socket);
+    worker.pid = -1;
+    worker.socket = -1;
+}
+
+void IsolatedExecutor::respawn(Worker &worker)
+{
+    kill_worker(worker);
+    ++respawns_;
+    spawn(worker);
+}
+
+IsolatedExecutor::Worker &IsolatedExecutor::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait(lock, [this] { return !idle_.empty(); });
+    Worker &worker = *idle_.back();
+    idle_.pop_back();
+    return worker;
+}
+
+void IsolatedExecutor::release(Worker &worker)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(&worker);
+    }
+    available_.notify_one();
+}
+
+void IsolatedExecutor::eigen_decomposition(const Eigen::MatrixXd &A,
+                                           Eigen::VectorXd &W,
+                                           Eigen::MatrixXd &V,
+                                           std::chrono::milliseconds timeout,
+                                           const CancellationToken *cancel)
+{
+    eigen_interface_detail::check_square(A.rows(), A.cols());
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const auto n = static_cast<lapack_int>(A.rows());
+
+    Worker &worker = acquire();
+    struct Release
+    {
+        IsolatedExecutor *executor;
+        Worker &worker;
+        ~Release()
+        {
+            executor->release(worker);
+        }
+    } release_worker{this, worker};
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    // A respawn may have failed earlier
+    if (worker.pid < 0)
+        spawn(worker);
+
+    const std::size_t bytes = std::max<std::size_t>(
+        region_doubles(n) * sizeof(double), sysconf(_SC_PAGESIZE));
+    if (bytes > worker.region_bytes)
+    {
+        if (ftruncate(worker.memfd, static_cast<off_t>(bytes)) != 0)
+            fail("growing the shared memory file");
+        if (worker.region != nullptr)
+            munmap(worker.region, worker.region_bytes);
+        worker.region_bytes = 0;
+        worker.region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, worker.memfd, 0);
+        if (worker.region == MAP_FAILED)
+        {
+            worker.region = nullptr;
+            fail("mapping the shared memory file");
+        }
+        worker.region_bytes = bytes;
+    }
+    double *a = static_cast<double *>(worker.region);
+    copy_matrix(A.data(), n, n, n, a, n);
+
+    const Request request{n, worker.region_bytes,
+                          analyze_structure(a, n, n, n)};
+    Reply reply;
+    bool replied = send_all(worker.socket, &request, sizeof request);
+    while (replied)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (cancel != nullptr && cancel->cancelled())
+        {
+            respawn(worker);
+            throw JobCancelled("eigen decomposition of order " +
+                               std::to_string(n) + " was cancelled");
+        }
+        if (now >= deadline)
+        {
+            respawn(worker);
+            throw JobTimeout("eigen decomposition of order " +
+                             std::to_string(n) + " exceeded its timeout of " +
+                             std::to_string(timeout.count()) + " ms");
+        }
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(deadline -
+                                                                 now);
+        if (cancel != nullptr)
+            wait = std::min(wait, std::chrono::milliseconds(10));
+        pollfd fd{worker.socket, POLLIN, 0};
+        const int ready = poll(&fd, 1, static_cast<int>(wait.count()));
+        if (ready < 0 && errno != EINTR)
+            fail("poll");
+        if (ready > 0)
+        {
+            replied = read_all(worker.socket, &reply, sizeof reply);
+            break;
+        }
+    }
+    if (!replied)
+    {
+        respawn(worker);
+        throw std::runtime_error("isolated executor: the worker process "
+                                 "died during an eigen decomposition of "
+                                 "order " +
+                                 std::to_string(n));
+    }
+    if (reply.error[0] != '\0')
+    {
+        if (reply.invalid_input)
+            throw std::invalid_argument(reply.error);
+        throw std::runtime_error(reply.error);
+    }
+
+    const std::size_t nn = static_cast<std::size_t>(n) * n;
+    V = Eigen::Map<const Eigen::MatrixXd>(a + nn, n, n);
+    W = Eigen::Map<const Eigen::VectorXd>(a + 2 * nn, n);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file isolated_executor.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines an executor that runs eigen decompositions
+ * in pre-forked worker processes, with per-job timeouts.
+ *
+ * A thread stuck in `dgeev` cannot be interrupted, but a process can be
+ * killed. Each worker is forked once, when the executor is created, and
+ * shares a memfd region with the parent: the parent writes A into it and
+ * analyzes its structure, the worker decomposes it in place with the solver
+ * `eigen_decomposition` would pick and leaves W and V next to it, so only a
+ * few bytes of control messages go through the worker's socket. If a job
+ * overruns its timeout or is cancelled, the worker is killed and a fresh one
+ * is forked in its place; the other workers keep running.
+ */
+
+#ifndef ISOLATED_EXECUTOR_H
+#define ISOLATED_EXECUTOR_H
+
+#include "solver_control.h"
+#include <Eigen/Dense>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * @brief Thrown when a job exceeds its timeout.
+ */
+class JobTimeout : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Thrown when a job is cancelled by its caller.
+ */
+class JobCancelled : public OperationCancelled
+{
+  public:
+    using OperationCancelled::OperationCancelled;
+};
+
+/**
+ * @brief A fixed set of worker processes running the LAPACK eigensolvers.
+ *
+ * `eigen_decomposition` may be called from several threads at once; each
+ * call takes an idle worker, waiting for one if all are busy. Create the
+ * executor early, before the program starts other threads: forking a
+ * multithreaded process only copies the calling thread, so the workers are
+ * forked up front, and a respawned worker runs nothing but LAPACK and the
+ * allocator.
+ */
+class IsolatedExecutor
+{
+  public:
+    /**
+     * @param workers The number of worker processes, at least 1.
+     * @throws std::runtime_error if a worker cannot be created.
+     */
+    explicit IsolatedExecutor(unsigned workers = 1);
+
+    /**
+     * @brief Kills the workers; jobs must not be running any more.
+     */
+    ~IsolatedExecutor();
+
+    IsolatedExecutor(const IsolatedExecutor &) = delete;
+    IsolatedExecutor &operator=(const IsolatedExecutor &) = delete;
+
+    /**
+     * @brief Compute the eigenvalues and eigenvectors of A in a worker.
+     *
+     * The results are the same as those of `eigen_decomposition(A, W, V)`.
+     *
+     * @param A The square input matrix.
+     * @param W The vector that will store the real parts of the eigenvalues.
+     * @param V The matrix that will store the eigenvectors.
+     * @param timeout The wall-clock limit of the job, from the time it gets
+     * a worker.
+     * @param cancel If given, the job is abandoned soon after the token is
+     * triggered (it is polled every few milliseconds).
+     * @throws JobTimeout or JobCancelled if the job was stopped (its worker
+     * is replaced), std::invalid_argument if A is not square or holds NaN
+     * or Inf, std::runtime_error if LAPACK fails or the worker dies.
+     */
+    void eigen_decomposition(const Eigen::MatrixXd &A, Eigen::VectorXd &W,
+                             Eigen::MatrixXd &V,
+                             std::chrono::milliseconds timeout,
+                             const CancellationToken *cancel = nullptr);
+
+    /**
+     * @brief The number of workers replaced so far after a timeout,
+     * cancellation or crash.
+     */
+    unsigned respawns() const
+    {
+        return respawns_.load();
+    }
+
+  private:
+    struct Worker
+    {
+        pid_t pid = -1;
+        int socket = -1; ///< the parent's end of the control socket
+        int memfd = -1;
+        void *region = nullptr;
+        std::size_t region_bytes = 0;
+    };
+
+    void shutdown();
+    void spawn(Worker &worker);
+    void kill_worker(Worker &worker);
+    void respawn(Worker &worker);
+    Worker &acquire();
+    void release(Worker &worker);
+
+    std::vector<Worker> workers_;
+    std::vector<Worker *> idle_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::atomic<unsigned> respawns_{0};
+};
+
+#endif // ISOLATED_EXECUTOR_H
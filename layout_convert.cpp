@@ -0,0 +1,121 @@
+/**
+ * @file layout_convert.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the layout and precision
+ * conversion kernels.
+ */
+
+#include "layout_convert.h"
+#include "parallel.h"
+
+namespace
+{
+
+/**
+ * @brief Matrices from this many elements on are converted in parallel.
+ */
+constexpr std::size_t parallel_elements = std::size_t(1) << 20;
+
+/**
+ * @brief Transpose blocks of at most this many rows are swept column by
+ * column: the source rows one destination column touches then stay in the
+ * cache and the TLB for the following columns.
+ */
+constexpr std::size_t sweep_rows = 512;
+
+unsigned thread_count(std::size_t rows, std::size_t cols, unsigned threads)
+{
+    if (threads != 0)
+        return threads;
+    return rows * cols >= parallel_elements ? default_thread_count() : 1;
+}
+
+template <typename From>
+void copy_columns(const From *src, std::size_t ld_src, std::size_t rows,
+                  std::size_t begin, std::size_t end, double *dst,
+                  std::size_t ld_dst)
+{
+    for (std::size_t j = begin; j < end; ++j)
+    {
+        const From *s = src + j * ld_src;
+        double *d = dst + j * ld_dst;
+#pragma omp simd
+        for (std::size_t i = 0; i < rows; ++i)
+            d[i] = static_cast<double>(s[i]);
+    }
+}
+
+template <typename From>
+void transpose_block(const From *src, std::size_t ld_src, std::size_t rows,
+                     std::size_t cols, double *dst, std::size_t ld_dst)
+{
+    if (rows <= sweep_rows)
+    {
+        for (std::size_t j = 0; j < cols; ++j)
+        {
+            const From *s = src + j;
+            double *d = dst + j * ld_dst;
+#pragma omp simd
+            for (std::size_t i = 0; i < rows; ++i)
+                d[i] = static_cast<double>(s[i * ld_src]);
+        }
+        return;
+    }
+    if (rows >= cols)
+    {
+        const std::size_t half = rows / 2;
+        transpose_block(src, ld_src, half, cols, dst, ld_dst);
+        transpose_block(src + half * ld_src, ld_src, rows - half, cols,
+                        dst + half, ld_dst);
+    }
+    else
+    {
+        const std::size_t half = cols / 2;
+        transpose_block(src, ld_src, rows, half, dst, ld_dst);
+        transpose_block(src + half, ld_src, rows, cols - half,
+                        dst + half * ld_dst, ld_dst);
+    }
+}
+
+} // namespace
+
+template <typename From>
+void copy_matrix(const From *src, std::size_t ld_src, std::size_t rows,
+                 std::size_t cols, double *dst, std::size_t ld_dst,
+                 unsigned threads)
+{
+    parallel_for(
+        cols,
+        [&](std::size_t begin, std::size_t end) {
+            copy_columns(src, ld_src, rows, begin, end, dst, ld_dst);
+        },
+        thread_count(rows, cols, threads));
+}
+
+template <typename From>
+void transpose_matrix(const From *src, std::size_t ld_src, std::size_t rows,
+                      std::size_t cols, double *dst, std::size_t ld_dst,
+                      unsigned threads)
+{
+    parallel_for(
+        cols,
+        [&](std::size_t begin, std::size_t end) {
+            transpose_block(src + begin, ld_src, rows, end - begin,
+                            dst + begin * ld_dst, ld_dst);
+        },
+        thread_count(rows, cols, threads));
+}
+
+template void copy_matrix<double>(const double *, std::size_t, std::size_t,
+                                  std::size_t, double *, std::size_t,
+                                  unsigned);
+template void copy_matrix<float>(const float *, std::size_t, std::size_t,
+                                 std::size_t, double *, std::size_t,
+                                 unsigned);
+template void transpose_matrix<double>(const double *, std::size_t,
+                                       std::size_t, std::size_t, double *,
+                                       std::size_t, unsigned);
+template void transpose_matrix<float>(const float *, std::size_t,
+                                      std::size_t, std::size_t, double *,
+                                      std::size_t, unsigned);
@@ -0,0 +1,52 @@
+/**
+ * @file layout_convert.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the kernels that bring matrices into the
+ * column-major double layout LAPACK wants.
+ *
+ * Both kernels read a matrix of double or float with any leading dimension
+ * and write doubles with any leading dimension, so one pass does the
+ * padding or unpadding, the precision conversion and, for
+ * `transpose_matrix`, the row- to column-major change. Their inner loops
+ * are `#pragma omp simd` loops, and large matrices are split by destination
+ * columns over `parallel_for` threads.
+ */
+
+#ifndef LAYOUT_CONVERT_H
+#define LAYOUT_CONVERT_H
+
+#include <cstddef>
+
+/**
+ * @brief Copy a rows x cols column-major matrix:
+ * dst[i + j * ld_dst] = src[i + j * ld_src].
+ *
+ * @tparam From double or float.
+ * @param threads The number of threads; 0 uses `default_thread_count()`
+ * for matrices of 2^20 elements or more and one thread below that, where
+ * starting threads costs more than it saves.
+ */
+template <typename From>
+void copy_matrix(const From *src, std::size_t ld_src, std::size_t rows,
+                 std::size_t cols, double *dst, std::size_t ld_dst,
+                 unsigned threads = 0);
+
+/**
+ * @brief Transpose into a rows x cols column-major matrix:
+ * dst[i + j * ld_dst] = src[j + i * ld_src].
+ *
+ * src is thus a rows x cols row-major matrix with row stride ld_src. The
+ * transpose recursively halves the larger dimension, cache-obliviously,
+ * until a block has few enough rows that sweeping it column by column
+ * keeps the source rows it touches in the cache.
+ *
+ * @tparam From double or float.
+ * @param threads As for `copy_matrix`.
+ */
+template <typename From>
+void transpose_matrix(const From *src, std::size_t ld_src, std::size_t rows,
+                      std::size_t cols, double *dst, std::size_t ld_dst,
+                      unsigned threads = 0);
+
+#endif // LAYOUT_CONVERT_H
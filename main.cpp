@@ -17,11 +17,21 @@
  */
 
 #include "eigen_interface.h"
+#include "memory_planner.h"
 #include <Eigen/Dense>
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 /**
  * @brief Check the relative reconstruction error of a matrix decomposition.
@@ -59,7 +69,8 @@ void check_decomposition(const Eigen::MatrixXd &A, const Eigen::VectorXd &W,
  *
  * This method takes in a matrix A and computes its condition number. The
  * condition number of a matrix is the ratio of the largest singular value to
- * the smallest singular value.
+ * the smallest singular value. Only the singular values are computed, using
+ * LAPACK's `dgesdd` through `singular_values`.
  *
  * @param A The input matrix for which to compute the condition number.
  *
@@ -67,12 +78,98 @@ void check_decomposition(const Eigen::MatrixXd &A, const Eigen::VectorXd &W,
  */
 double compute_condition_number(const Eigen::MatrixXd &A)
 {
-    Eigen::JacobiSVD<Eigen::MatrixXd> svd(A);
-    double cond_number =
-        svd.singularValues()(0) / svd.singularValues().tail(1)(0);
+    Eigen::VectorXd S;
+    singular_values(A, S);
+    double cond_number = S(0) / S.tail(1)(0);
     return cond_number;
 }
 
+/**
+ * @brief Parse a byte count with an optional K, M or G suffix (powers of
+ * 1024), e.g. "512M".
+ *
+ * @throws std::invalid_argument if the text is not such a count,
+ * std::out_of_range if the count does not fit in std::size_t.
+ */
+std::size_t parse_bytes(const std::string &text)
+{
+    // std::stoull accepts a sign and wraps a negative count around
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0])))
+        throw std::invalid_argument("not a byte count: " + text);
+    std::size_t pos = 0;
+    const unsigned long long value = std::stoull(text, &pos);
+    std::size_t shift = 0;
+    if (pos + 1 == text.size())
+    {
+        static const char units[] = "KMG";
+        const char *suffix = std::strchr(
+            units, std::toupper(static_cast<unsigned char>(text[pos])));
+        if (suffix == nullptr || *suffix == '\0')
+            throw std::invalid_argument("unknown size suffix: " + text);
+        shift = 10 * (suffix - units + 1);
+        ++pos;
+    }
+    if (pos != text.size())
+        throw std::invalid_argument("not a byte count: " + text);
+    if (value > (SIZE_MAX >> shift))
+        throw std::out_of_range("byte count too large: " + text);
+    return static_cast<std::size_t>(value) << shift;
+}
+
+/**
+ * @brief Estimate the ratio of the run times of two methods from paired
+ * rounds, with a bootstrap confidence interval.
+ *
+ * Round i timed method a at a[i] and method b at b[i] on the same input. The
+ * estimate is the geometric mean of the per-round ratios a[i] / b[i], so
+ * that a round on a slow input counts as much as one on a fast input. The
+ * interval is the percentile bootstrap of that estimate over resampled
+ * rounds.
+ *
+ * @param a The run times of the first method.
+ * @param b The run times of the second method, paired with a.
+ * @param confidence The confidence level, e.g. 0.95.
+ * @param ratio The variable to store the estimated ratio a / b.
+ * @param lower The variable to store the lower bound of the interval.
+ * @param upper The variable to store the upper bound of the interval.
+ * @param resamples The number of bootstrap resamples.
+ */
+void bootstrap_time_ratio(const std::vector<double> &a,
+                          const std::vector<double> &b, double confidence,
+                          double &ratio, double &lower, double &upper,
+                          int resamples = 2000)
+{
+    const std::size_t rounds = std::min(a.size(), b.size());
+    std::vector<double> log_ratios(rounds);
+    for (std::size_t i = 0; i < rounds; ++i)
+        log_ratios[i] = std::log(a[i] / b[i]);
+
+    double sum = 0.0;
+    for (double r : log_ratios)
+        sum += r;
+    ratio = std::exp(sum / rounds);
+
+    // Fixed seed: the same timings always give the same interval
+    std::mt19937 rng(20261018);
+    std::uniform_int_distribution<std::size_t> pick(0, rounds - 1);
+    std::vector<double> estimates(resamples);
+    for (double &estimate : estimates)
+    {
+        double resample_sum = 0.0;
+        for (std::size_t i = 0; i < rounds; ++i)
+            resample_sum += log_ratios[pick(rng)];
+        estimate = resample_sum / rounds;
+    }
+    std::sort(estimates.begin(), estimates.end());
+    const double tail = (1.0 - confidence) / 2.0;
+    const auto at = [&](double q) {
+        const std::size_t k = static_cast<std::size_t>(q * (resamples - 1));
+        return std::exp(estimates[k]);
+    };
+    lower = at(tail);
+    upper = at(1.0 - tail);
+}
+
 /**
  * @brief The main entry point of the program.
  *
@@ -83,15 +180,57 @@ double compute_condition_number(const Eigen::MatrixXd &A)
  * differences, relative reconstruction errors, and the faster method to the
  * console and an output file.
  *
+ * By default the summary compares the speed of the two methods on the
+ * single timed runs above. With `--ab-rounds=N` it runs an A/B test
+ * instead: for N rounds, both methods decompose a fresh random matrix in
+ * random order, so that neither benefits systematically from running second
+ * (warm caches, turbo state) or from a lucky input. A method is declared
+ * faster only if the 95% bootstrap confidence interval of the paired time
+ * ratio excludes 1.
+ *
+ * With `--mem-budget=SIZE` the Fortran LAPACK decomposition is planned to
+ * fit the budget (see memory_planner.h): the budget must hold the matrix and
+ * the condition number computation, and the rest goes to the cheapest
+ * decomposition plan that fits. If none does, the program stops before
+ * allocating anything. The Eigen comparison and the reconstruction checks
+ * are not part of the budget.
+ *
  * @param argc The number of command line arguments.
  * @param argv An array of strings representing the command line arguments.
  * @return Returns 0 if the program executed successfully, 1 otherwise.
  */
 int main(int argc, char *argv[])
 {
-    if (argc != 2)
+    const char *budget_option = "--mem-budget=";
+    const char *rounds_option = "--ab-rounds=";
+    const char *budget_text = nullptr;
+    int rounds = 0;
+    bool valid_arguments = argc >= 2;
+    for (int i = 2; i < argc && valid_arguments; ++i)
     {
-        std::cerr << "Usage: " << argv[0] << " <use_lapack_in_eigen: 0 or 1>"
+        if (!std::strncmp(argv[i], budget_option, std::strlen(budget_option)))
+            budget_text = argv[i] + std::strlen(budget_option);
+        else if (!std::strncmp(argv[i], rounds_option,
+                               std::strlen(rounds_option)))
+        {
+            try
+            {
+                rounds = std::stoi(argv[i] + std::strlen(rounds_option));
+            }
+            catch (const std::exception &)
+            {
+                rounds = -1;
+            }
+            valid_arguments = rounds == 0 || rounds >= 2;
+        }
+        else
+            valid_arguments = false;
+    }
+    if (!valid_arguments)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <use_lapack_in_eigen: 0 or 1>"
+                     " [--mem-budget=SIZE[K|M|G]] [--ab-rounds=N (0 or >= 2)]"
                   << std::endl;
         return 1;
     }
@@ -103,6 +242,43 @@ int main(int argc, char *argv[])
     std::cout << "Enter the size of the matrix: ";
     std::cin >> size;
 
+    // Plan the Fortran LAPACK decomposition before allocating anything
+    EigenPlan plan = EigenPlan::Full;
+    if (budget_text != nullptr)
+    {
+        try
+        {
+            const std::size_t budget = parse_bytes(budget_text);
+            const std::size_t reserved =
+                static_cast<std::size_t>(size) * size * sizeof(double) +
+                singular_values_bytes(size, size);
+            if (budget < reserved)
+            {
+                throw std::runtime_error(
+                    "the memory budget of " + std::to_string(budget) +
+                    " bytes does not hold the matrix and its condition "
+                    "number computation (" +
+                    std::to_string(reserved) + " bytes)");
+            }
+            PlanRequest request;
+            request.n = size;
+            const PlanEstimate estimate =
+                select_plan(request, budget - reserved);
+            plan = estimate.plan;
+            std::cout << "Plan: " << plan_name(plan) << ", peak "
+                      << estimate.peak_bytes + reserved << " bytes"
+                      << std::endl;
+            outfile << "Plan: " << plan_name(plan) << ", peak "
+                    << estimate.peak_bytes + reserved << " bytes" << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in memory planning: " << e.what()
+                      << std::endl;
+            return 1;
+        }
+    }
+
     Eigen::MatrixXd A =
         Eigen::MatrixXd::Random(size, size); // Generate a random matrix
 
@@ -148,7 +324,7 @@ int main(int argc, char *argv[])
     try
     {
         auto start = std::chrono::high_resolution_clock::now();
-        eigen_decomposition(A, W_fortran, V_fortran);
+        execute_plan(plan, A, W_fortran, V_fortran);
         auto end = std::chrono::high_resolution_clock::now();
         duration_fortran = std::chrono::duration<double>(end - start).count();
         std::cout << "Fortran LAPACK Duration: " << duration_fortran
@@ -218,6 +394,71 @@ int main(int argc, char *argv[])
     max_diff_values = (W_fortran - W_eigen).cwiseAbs().maxCoeff();
     max_diff_vectors = (V_fortran - V_eigen).cwiseAbs().maxCoeff();
 
+    // A/B timing, if requested: every round runs both methods on a fresh
+    // matrix, in an order drawn at random per round
+    std::vector<double> ab_fortran, ab_eigen;
+    std::mt19937 order_rng(std::random_device{}());
+    try
+    {
+        for (int round = 0; round < rounds; ++round)
+        {
+            Eigen::MatrixXd A_round = Eigen::MatrixXd::Random(size, size);
+            int order[] = {0, 1};
+            std::shuffle(std::begin(order), std::end(order), order_rng);
+            for (int method : order)
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+                if (method == 0)
+                    execute_plan(plan, A_round, W_fortran, V_fortran);
+                else
+                {
+                    Eigen::EigenSolver<Eigen::MatrixXd> solver(A_round);
+                    W_eigen = solver.eigenvalues().real();
+                    V_eigen = solver.eigenvectors().real();
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                (method == 0 ? ab_fortran : ab_eigen)
+                    .push_back(
+                        std::chrono::duration<double>(end - start).count());
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in A/B eigenvalue decomposition: " << e.what()
+                  << std::endl;
+        return 1;
+    }
+
+    std::ostringstream ab_result;
+    if (rounds == 0)
+    {
+        ab_result << (duration_fortran < duration_eigen ? "Fortran LAPACK"
+                                                        : "Eigen Library")
+                  << " was faster by "
+                  << std::abs(duration_eigen - duration_fortran)
+                  << " seconds in a single run\n";
+    }
+    else
+    {
+        double ratio, ratio_lower, ratio_upper;
+        bootstrap_time_ratio(ab_fortran, ab_eigen, 0.95, ratio, ratio_lower,
+                             ratio_upper);
+        ab_result << "A/B test over " << rounds
+                  << " rounds: Fortran LAPACK / Eigen Library time ratio "
+                  << ratio << " (95% CI " << ratio_lower << " to "
+                  << ratio_upper << ")\n";
+        if (ratio_upper < 1.0)
+            ab_result << "Fortran LAPACK was faster by a factor of "
+                      << 1.0 / ratio << "\n";
+        else if (ratio_lower > 1.0)
+            ab_result << "Eigen Library was faster by a factor of " << ratio
+                      << "\n";
+        else
+            ab_result << "No significant difference between Fortran LAPACK "
+                         "and Eigen Library\n";
+    }
+
     // Output final comparison
     std::cout << "\nSummary:\n";
     std::cout << "Chosen method: "
@@ -238,10 +479,7 @@ int main(int argc, char *argv[])
               << relative_error_fortran << "\n";
     std::cout << "Eigen Library relative reconstruction error: "
               << relative_error_eigen << "\n";
-    std::cout << (duration_fortran < duration_eigen ? "Fortran LAPACK"
-                                                    : "Eigen Library")
-              << " was faster by "
-              << std::abs(duration_eigen - duration_fortran) << " seconds\n";
+    std::cout << ab_result.str();
 
     outfile << "\nSummary:\n";
     outfile << "Chosen method: "
@@ -261,10 +499,7 @@ int main(int argc, char *argv[])
             << relative_error_fortran << "\n";
     outfile << "Eigen Library relative reconstruction error: "
             << relative_error_eigen << "\n";
-    outfile << (duration_fortran < duration_eigen ? "Fortran LAPACK"
-                                                  : "Eigen Library")
-            << " was faster by " << std::abs(duration_eigen - duration_fortran)
-            << " seconds\n";
+    outfile << ab_result.str();
 
     outfile.close();
     return 0;
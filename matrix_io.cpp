@@ -0,0 +1,178 @@
+/**
+ * @file matrix_io.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the framed binary matrix
+ * format.
+ */
+
+#include "matrix_io.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+
+const char magic[4] = {'E', 'I', 'G', 'M'};
+
+[[noreturn]] void fail(const char *what)
+{
+    throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+FrameHeader frame_header(FrameKind kind, std::uint64_t rows,
+                         std::uint64_t cols)
+{
+    FrameHeader header;
+    std::memcpy(header.magic, magic, sizeof magic);
+    header.kind = static_cast<std::uint32_t>(kind);
+    header.rows = rows;
+    header.cols = cols;
+    return header;
+}
+
+std::size_t frame_payload_bytes(const FrameHeader &header)
+{
+    if (std::memcmp(header.magic, magic, sizeof magic) != 0)
+        throw std::runtime_error("not a matrix frame: bad magic");
+    const std::uint64_t limit =
+        std::numeric_limits<std::size_t>::max() / sizeof(double);
+    if (header.cols != 0 && header.rows > limit / header.cols)
+    {
+        throw std::runtime_error(
+            "matrix frame of " + std::to_string(header.rows) + "x" +
+            std::to_string(header.cols) + " is too large");
+    }
+    return static_cast<std::size_t>(header.rows * header.cols) *
+           sizeof(double);
+}
+
+std::size_t read_full(int fd, void *data, std::size_t bytes)
+{
+    std::size_t done = 0;
+    while (done < bytes)
+    {
+        const ssize_t got =
+            read(fd, static_cast<char *>(data) + done, bytes - done);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got < 0)
+            fail("cannot read matrix frame");
+        if (got == 0)
+            break;
+        done += got;
+    }
+    return done;
+}
+
+void write_full(int fd, const void *data, std::size_t bytes)
+{
+    std::size_t done = 0;
+    while (done < bytes)
+    {
+        const ssize_t put =
+            write(fd, static_cast<const char *>(data) + done, bytes - done);
+        if (put < 0 && errno == EINTR)
+            continue;
+        if (put < 0)
+            fail("cannot write matrix frame");
+        done += put;
+    }
+}
+
+bool read_frame_header(int fd, FrameHeader &header)
+{
+    const std::size_t got = read_full(fd, &header, sizeof header);
+    if (got == 0)
+        return false;
+    if (got != sizeof header)
+        throw std::runtime_error("truncated matrix frame header");
+    frame_payload_bytes(header);
+    return true;
+}
+
+void read_frame_payload(int fd, const FrameHeader &header, double *data)
+{
+    const std::size_t bytes = frame_payload_bytes(header);
+    if (read_full(fd, data, bytes) != bytes)
+        throw std::runtime_error("truncated matrix frame payload");
+}
+
+void write_frame(int fd, FrameKind kind, std::uint64_t rows,
+                 std::uint64_t cols, const double *data)
+{
+    const FrameHeader header = frame_header(kind, rows, cols);
+    write_full(fd, &header, sizeof header);
+    write_full(fd, data, frame_payload_bytes(header));
+}
+
+MappedFrameFile::MappedFrameFile(const std::string &path, std::size_t bytes)
+    : path_(path), bytes_(bytes)
+{
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+        fail(("cannot create " + path).c_str());
+    int error = 0;
+    if (bytes_ != 0)
+    {
+#ifdef __linux__
+        error = posix_fallocate(fd_, 0, static_cast<off_t>(bytes_));
+        // File systems without fallocate get a sparse file instead
+        if (error == EOPNOTSUPP || error == EINVAL)
+            error = 0;
+#endif
+        if (error == 0 && ftruncate(fd_, static_cast<off_t>(bytes_)) != 0)
+            error = errno;
+        if (error == 0)
+        {
+            void *data = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE,
+                              MAP_SHARED, fd_, 0);
+            if (data == MAP_FAILED)
+                error = errno;
+            else
+                data_ = static_cast<char *>(data);
+        }
+    }
+    if (error != 0)
+    {
+        close(fd_);
+        errno = error;
+        fail(("cannot allocate and map " + path).c_str());
+    }
+}
+
+MappedFrameFile::~MappedFrameFile()
+{
+    if (data_ != nullptr)
+        munmap(data_, bytes_);
+    close(fd_);
+}
+
+double *MappedFrameFile::frame(std::size_t offset, FrameKind kind,
+                               std::uint64_t rows, std::uint64_t cols)
+{
+    const FrameHeader header = frame_header(kind, rows, cols);
+    const std::size_t payload = frame_payload_bytes(header);
+    if (offset > bytes_ || bytes_ - offset < sizeof header ||
+        bytes_ - offset - sizeof header < payload)
+    {
+        throw std::out_of_range("frame at offset " + std::to_string(offset) +
+                                " does not fit in " + path_);
+    }
+    std::memcpy(data_ + offset, &header, sizeof header);
+    return reinterpret_cast<double *>(data_ + offset + sizeof header);
+}
+
+void MappedFrameFile::sync()
+{
+    if (data_ != nullptr && msync(data_, bytes_, MS_SYNC) != 0)
+        fail(("cannot write " + path_).c_str());
+}
@@ -0,0 +1,165 @@
+/**
+ * @file matrix_io.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the framed binary matrix format used by
+ * the command line tools to exchange matrices through pipes and files.
+ *
+ * A frame is a 24-byte header followed by rows x cols doubles in
+ * column-major order:
+ *
+ *     offset  0  char[4]   magic "EIGM"
+ *     offset  4  uint32    kind (see `FrameKind`)
+ *     offset  8  uint64    rows
+ *     offset 16  uint64    cols
+ *     offset 24  double[]  the payload
+ *
+ * Header fields and payload use the byte order of the machine. Frames
+ * follow each other without padding, so a stream or a file is simply a
+ * sequence of frames, and every payload starts 8-byte aligned when the
+ * stream does.
+ */
+
+#ifndef MATRIX_IO_H
+#define MATRIX_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief What a frame holds.
+ */
+enum class FrameKind : std::uint32_t
+{
+    Matrix = 0,      ///< an input matrix
+    Eigenvalues = 1, ///< n x 2: real parts, then imaginary parts
+    Eigenvectors = 2 ///< n x n, in the layout of `dgeev`
+};
+
+/**
+ * @brief The header of a frame.
+ */
+struct FrameHeader
+{
+    char magic[4];
+    std::uint32_t kind;
+    std::uint64_t rows;
+    std::uint64_t cols;
+};
+
+static_assert(sizeof(FrameHeader) == 24, "frame headers are 24 bytes");
+
+/**
+ * @brief A header with the magic filled in.
+ */
+FrameHeader frame_header(FrameKind kind, std::uint64_t rows,
+                         std::uint64_t cols);
+
+/**
+ * @brief The payload size of a frame in bytes.
+ *
+ * @throws std::runtime_error if the magic is wrong or the size overflows.
+ */
+std::size_t frame_payload_bytes(const FrameHeader &header);
+
+/**
+ * @brief Read exactly bytes bytes, retrying short reads.
+ *
+ * @return The number of bytes read, less than bytes only at end of file.
+ * @throws std::runtime_error if reading fails.
+ */
+std::size_t read_full(int fd, void *data, std::size_t bytes);
+
+/**
+ * @brief Write exactly bytes bytes, retrying short writes.
+ *
+ * @throws std::runtime_error if writing fails.
+ */
+void write_full(int fd, const void *data, std::size_t bytes);
+
+/**
+ * @brief Read the header of the next frame.
+ *
+ * @return false at the end of the stream, between two frames.
+ * @throws std::runtime_error if the stream ends inside the header or the
+ * header is not a valid frame header.
+ */
+bool read_frame_header(int fd, FrameHeader &header);
+
+/**
+ * @brief Read the payload of a frame whose header was just read.
+ *
+ * @param data Room for `frame_payload_bytes(header)` bytes.
+ * @throws std::runtime_error if the stream ends inside the payload.
+ */
+void read_frame_payload(int fd, const FrameHeader &header, double *data);
+
+/**
+ * @brief Write a frame.
+ *
+ * @throws std::runtime_error if writing fails.
+ */
+void write_frame(int fd, FrameKind kind, std::uint64_t rows,
+                 std::uint64_t cols, const double *data);
+
+/**
+ * @brief A file of frames created at its final size and mapped into memory,
+ * so that results can be computed straight into it.
+ *
+ * The file's blocks are allocated when it is created, so running out of
+ * disk space shows up as an exception there rather than as a SIGBUS when
+ * the mapping is written. Pages that have been written are flushed by the
+ * kernel as it sees fit and can be evicted under memory pressure, so a
+ * result larger than RAM still fits.
+ */
+class MappedFrameFile
+{
+  public:
+    /**
+     * @brief Create (or truncate) the file at path with bytes bytes and
+     * map it.
+     *
+     * @throws std::runtime_error if the file cannot be created, allocated
+     * or mapped.
+     */
+    MappedFrameFile(const std::string &path, std::size_t bytes);
+
+    ~MappedFrameFile();
+
+    MappedFrameFile(const MappedFrameFile &) = delete;
+    MappedFrameFile &operator=(const MappedFrameFile &) = delete;
+
+    char *data()
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return bytes_;
+    }
+
+    /**
+     * @brief Write a frame header at offset and return its payload.
+     *
+     * @throws std::out_of_range if the frame does not fit in the file.
+     */
+    double *frame(std::size_t offset, FrameKind kind, std::uint64_t rows,
+                  std::uint64_t cols);
+
+    /**
+     * @brief Write the whole mapping back to the file and wait for it.
+     *
+     * @throws std::runtime_error if writing fails.
+     */
+    void sync();
+
+  private:
+    std::string path_;
+    std::size_t bytes_;
+    int fd_ = -1;
+    char *data_ = nullptr;
+};
+
+#endif // MATRIX_IO_H
@@ -0,0 +1,327 @@
+/**
+ * @file memory_planner.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the memory planner and of the
+ * plan executors.
+ *
+ * The cost model is a flop count: `dgeev` takes about 10 n^3 flops for the
+ * eigenvalues and 25 n^3 with eigenvectors, `dspev` about 4/3 n^3 and 9 n^3.
+ * `dspev` works on packed storage with level-2 BLAS, which is counted twice;
+ * out-of-core runs are counted four times, as they may page to disk.
+ */
+
+#include "memory_planner.h"
+#include "eigen_interface.h"
+#include "layout_convert.h"
+#include "sampled_verifier.h"
+#include "structure_analyzer.h"
+#include "trace_recorder.h"
+#include "workspace_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using eigen_interface_detail::check_lapack_info;
+
+namespace
+{
+
+std::size_t doubles_bytes(std::size_t count)
+{
+    return count * sizeof(double);
+}
+
+std::size_t pool_bytes(std::size_t doubles)
+{
+    return WorkspacePool::class_bytes(
+        WorkspacePool::size_class(doubles_bytes(doubles)));
+}
+
+std::size_t packed_size(std::size_t n)
+{
+    return n * (n + 1) / 2;
+}
+
+/**
+ * @brief An unlinked temporary file mapped into memory.
+ *
+ * Its pages are backed by the file rather than by swap, so the kernel can
+ * write them back and evict them under memory pressure.
+ */
+class ScratchMapping
+{
+  public:
+    explicit ScratchMapping(std::size_t bytes) : bytes_(bytes)
+    {
+        const char *dir = std::getenv("TMPDIR");
+        std::string path = std::string(dir != nullptr ? dir : "/tmp") +
+                           "/eigen_scratch_XXXXXX";
+        const int fd = mkstemp(&path[0]);
+        if (fd < 0)
+            fail("mkstemp");
+        unlink(path.c_str());
+        // Reserve the blocks up front: a sparse file would only run out of
+        // disk when dgeev first writes a page, as a SIGBUS
+        int error = 0;
+        const char *call = "posix_fallocate";
+#ifdef __linux__
+        error = posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+        // File systems without fallocate get a sparse file instead
+        if (error == EOPNOTSUPP || error == EINVAL)
+            error = 0;
+#endif
+        if (error == 0 && ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            error = errno;
+            call = "ftruncate";
+        }
+        if (error != 0)
+        {
+            close(fd);
+            errno = error;
+            fail(call);
+        }
+        data_ = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                     0);
+        close(fd);
+        if (data_ == MAP_FAILED)
+            fail("mmap");
+    }
+
+    ~ScratchMapping()
+    {
+        munmap(data_, bytes_);
+    }
+
+    ScratchMapping(const ScratchMapping &) = delete;
+    ScratchMapping &operator=(const ScratchMapping &) = delete;
+
+    double *data() const
+    {
+        return static_cast<double *>(data_);
+    }
+
+  private:
+    [[noreturn]] static void fail(const char *call)
+    {
+        throw std::runtime_error(std::string("out-of-core scratch file: ") +
+                                 call + " failed: " + std::strerror(errno));
+    }
+
+    std::size_t bytes_;
+    void *data_ = nullptr;
+};
+
+/**
+ * @brief `solve_eigen` on an n x n matrix stored at a with leading dimension
+ * n, using a leased workspace without a matrix buffer.
+ */
+void run_dgeev(lapack_int n, double *a, Eigen::VectorXd &W,
+               Eigen::MatrixXd &V, bool compute_vectors)
+{
+    const char job = compute_vectors ? 'V' : 'N';
+    auto ws = eigen_interface_detail::lease_eigen_workspace(n, job, false);
+    double dummy;
+    double *v = &dummy;
+    lapack_int ldv = 1;
+    if (compute_vectors)
+    {
+        V.resize(n, n);
+        v = V.data();
+        ldv = std::max<lapack_int>(1, n);
+    }
+    W.resize(n);
+    eigen_interface_detail::solve_eigen(n, a, ws.lda, job, ws.wr, ws.wi, v,
+                                        ldv, ws);
+    std::copy(ws.wr, ws.wr + n, W.data());
+}
+
+} // namespace
+
+const char *plan_name(EigenPlan plan)
+{
+    switch (plan)
+    {
+    case EigenPlan::Full:
+        return "full";
+    case EigenPlan::ValuesOnly:
+        return "eigenvalues-only";
+    case EigenPlan::InPlace:
+        return "in-place";
+    case EigenPlan::Packed:
+        return "packed";
+    case EigenPlan::OutOfCore:
+        return "out-of-core";
+    }
+    return "unknown";
+}
+
+std::vector<PlanEstimate> estimate_plans(const PlanRequest &request)
+{
+    if (request.n < 1)
+    {
+        throw std::invalid_argument("estimate_plans: n = " +
+                                    std::to_string(request.n) +
+                                    " must be positive");
+    }
+    eigen_interface_detail::check_lapack_size(request.n, request.n);
+    const auto n = static_cast<lapack_int>(request.n);
+    const std::size_t nn = static_cast<std::size_t>(n) * n;
+    const bool vectors = request.compute_vectors;
+    const char job = vectors ? 'V' : 'N';
+
+    // The outputs, common to all plans
+    const std::size_t outputs = doubles_bytes(n + (vectors ? nn : 0));
+    const double dgeev_cost = vectors ? 25.0 : 10.0;
+    const double dspev_cost = 2.0 * (vectors ? 9.0 : 4.0 / 3.0);
+    const std::size_t no_matrix =
+        eigen_interface_detail::eigen_workspace_bytes(n, job, false);
+    const std::size_t packed =
+        pool_bytes(packed_size(n) + 3 * static_cast<std::size_t>(n));
+    // Every dgeev plan analyzes the matrix first, while its workspace is
+    // leased; the Full plan is also the one traced and verified, and both
+    // keep an unpadded copy of A while active
+    const std::size_t analysis = analyze_structure_bytes(n, n);
+    const std::size_t observers = (trace_active() ? doubles_bytes(nn) : 0) +
+                                  (verifier_active() ? doubles_bytes(nn) : 0);
+
+    std::vector<PlanEstimate> plans;
+    plans.push_back({EigenPlan::Full, vectors,
+                     eigen_interface_detail::eigen_workspace_bytes(n) +
+                         analysis + observers + outputs,
+                     0, dgeev_cost});
+    plans.push_back({EigenPlan::ValuesOnly, !vectors,
+                     eigen_interface_detail::eigen_workspace_bytes(n, 'N') +
+                         analysis + outputs,
+                     0, dgeev_cost});
+    plans.push_back({EigenPlan::InPlace, request.input_disposable,
+                     no_matrix + analysis + outputs, 0, dgeev_cost});
+    plans.push_back({EigenPlan::Packed, request.symmetric, packed + outputs,
+                     0, dspev_cost});
+    plans.push_back({EigenPlan::OutOfCore, true,
+                     no_matrix + analysis + outputs, doubles_bytes(nn),
+                     4.0 * dgeev_cost});
+    return plans;
+}
+
+PlanEstimate select_plan(const PlanRequest &request, std::size_t budget_bytes)
+{
+    const std::vector<PlanEstimate> plans = estimate_plans(request);
+    const PlanEstimate *best = nullptr;
+    const PlanEstimate *smallest = nullptr;
+    for (const PlanEstimate &p : plans)
+    {
+        if (!p.applicable)
+            continue;
+        if (smallest == nullptr || p.peak_bytes < smallest->peak_bytes)
+            smallest = &p;
+        if (p.peak_bytes <= budget_bytes &&
+            (best == nullptr || p.cost < best->cost))
+            best = &p;
+    }
+    if (best == nullptr)
+    {
+        throw std::runtime_error(
+            "no eigen decomposition plan for n = " +
+            std::to_string(request.n) + " fits in the memory budget of " +
+            std::to_string(budget_bytes) + " bytes; the smallest, " +
+            plan_name(smallest->plan) + ", needs " +
+            std::to_string(smallest->peak_bytes) + " bytes");
+    }
+    return *best;
+}
+
+void execute_plan(EigenPlan plan, Eigen::MatrixXd &A, Eigen::VectorXd &W,
+                  Eigen::MatrixXd &V, bool compute_vectors)
+{
+    eigen_interface_detail::check_square(A.rows(), A.cols());
+    eigen_interface_detail::check_lapack_size(A.rows(), A.cols());
+    const auto n = static_cast<lapack_int>(A.rows());
+    if ((plan == EigenPlan::Full && !compute_vectors) ||
+        (plan == EigenPlan::ValuesOnly && compute_vectors))
+    {
+        throw std::invalid_argument(
+            std::string("execute_plan: the ") + plan_name(plan) +
+            " plan cannot be run with compute_vectors = " +
+            (compute_vectors ? "true" : "false"));
+    }
+
+    switch (plan)
+    {
+    case EigenPlan::Full:
+        eigen_decomposition(A, W, V);
+        break;
+    case EigenPlan::ValuesOnly:
+    {
+        auto ws = eigen_interface_detail::lease_eigen_workspace(n, 'N');
+        eigen_interface_detail::load_matrix(A, ws.a, ws.lda);
+        double dummy;
+        eigen_interface_detail::solve_eigen(n, ws.a, ws.lda, 'N', ws.wr,
+                                            ws.wi, &dummy, 1, ws);
+        W = Eigen::Map<Eigen::VectorXd>(ws.wr, n);
+        break;
+    }
+    case EigenPlan::InPlace:
+        run_dgeev(n, A.data(), W, V, compute_vectors);
+        break;
+    case EigenPlan::Packed:
+    {
+        const std::size_t packed = packed_size(n);
+        WorkspaceLease lease = WorkspacePool::instance().acquire_doubles(
+            packed + 3 * static_cast<std::size_t>(n));
+        double *ap = lease.data();
+        for (lapack_int j = 0; j < n; ++j)
+        {
+            std::copy(A.data() + j * A.rows() + j,
+                      A.data() + (j + 1) * A.rows(), ap);
+            ap += n - j;
+        }
+        double dummy;
+        double *z = &dummy;
+        lapack_int ldz = 1;
+        if (compute_vectors)
+        {
+            V.resize(n, n);
+            z = V.data();
+            ldz = n;
+        }
+        W.resize(n);
+        lapack_int info;
+        symmetric_packed_eigen(n, lease.data(), compute_vectors ? 'V' : 'N',
+                               W.data(), z, ldz, lease.data() + packed,
+                               &info);
+        check_lapack_info("dspev", info);
+        break;
+    }
+    case EigenPlan::OutOfCore:
+    {
+        ScratchMapping scratch(
+            doubles_bytes(static_cast<std::size_t>(n) * n));
+        copy_matrix(A.data(), n, n, n, scratch.data(), n);
+        run_dgeev(n, scratch.data(), W, V, compute_vectors);
+        break;
+    }
+    }
+}
+
+std::size_t singular_values_bytes(Eigen::Index m, Eigen::Index n)
+{
+    eigen_interface_detail::check_lapack_size(m, n);
+    lapack_int lwork, liwork, info;
+    svd_workspace_query(static_cast<lapack_int>(m),
+                        static_cast<lapack_int>(n), 'N', &lwork, &liwork,
+                        &info);
+    check_lapack_info("dgesdd workspace query", info);
+    // SvdContext: the matrix copy, rounded to cache lines, then the workspace
+    const std::size_t a_size = (static_cast<std::size_t>(m) * n + 7) / 8 * 8;
+    return pool_bytes(a_size + lwork) +
+           static_cast<std::size_t>(liwork) * sizeof(lapack_int) +
+           doubles_bytes(std::min(m, n));
+}
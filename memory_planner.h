@@ -0,0 +1,123 @@
+/**
+ * @file memory_planner.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the memory planner that picks an eigen
+ * decomposition algorithm fitting a memory budget.
+ *
+ * For large n the buffers of a decomposition (the working copy of A, the
+ * eigenvectors and the LAPACK workspace) no longer fit in memory, and simply
+ * allocating them gets the process OOM-killed or thrashing. The planner
+ * computes, before anything is allocated, the peak memory of every
+ * candidate plan from the LAPACK workspace queries and the workspace pool's
+ * size classes, and picks the fastest plan that fits the budget, or fails
+ * with a clear error.
+ *
+ * The peak counts what the call itself allocates: the workspace, the
+ * structure analysis' row flags and, while a trace or a verifier is active,
+ * their copies of A. Samples the verifier queued from earlier calls, at
+ * most a few matrices, are its own and not counted.
+ */
+
+#ifndef MEMORY_PLANNER_H
+#define MEMORY_PLANNER_H
+
+#include <Eigen/Dense>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief The ways the eigen decomposition of an n x n matrix can be run.
+ */
+enum class EigenPlan
+{
+    Full,       ///< `eigen_decomposition`: copy of A, eigenvectors, workspace
+    ValuesOnly, ///< `dgeev` on a copy of A without eigenvectors
+    InPlace,    ///< `dgeev` directly in the caller's matrix, destroying it
+    Packed,     ///< `dspev` on the packed lower triangle (symmetric A only)
+    OutOfCore   ///< like InPlace, on a copy of A in a file-backed mapping
+};
+
+/**
+ * @brief What the caller needs from the decomposition.
+ */
+struct PlanRequest
+{
+    Eigen::Index n = 0;            ///< order of the matrix
+    bool compute_vectors = true;   ///< whether eigenvectors are needed
+    bool symmetric = false;        ///< A is symmetric: enables Packed
+    bool input_disposable = false; ///< A may be destroyed: enables InPlace
+};
+
+/**
+ * @brief The memory and estimated cost of one plan for a request.
+ */
+struct PlanEstimate
+{
+    EigenPlan plan;
+    bool applicable;        ///< whether the plan can serve the request
+    std::size_t peak_bytes; ///< memory allocated by the run, excluding A
+    std::size_t disk_bytes; ///< file-backed scratch space (OutOfCore only)
+    double cost;            ///< estimated run time, in units of n^3 flops
+};
+
+/**
+ * @brief The name of a plan, e.g. "full" or "out-of-core".
+ */
+const char *plan_name(EigenPlan plan);
+
+/**
+ * @brief Estimate every plan for a request, in the order of `EigenPlan`.
+ *
+ * The peak includes the outputs W and (if requested) V, but not the input
+ * matrix, which the caller already holds.
+ *
+ * @throws std::invalid_argument if n < 1 or n is too large for the LAPACK
+ * integer type.
+ */
+std::vector<PlanEstimate> estimate_plans(const PlanRequest &request);
+
+/**
+ * @brief Choose the plan with the lowest estimated cost whose peak memory
+ * fits the budget.
+ *
+ * @param request What the caller needs.
+ * @param budget_bytes The memory available to the decomposition.
+ * @return The estimate of the chosen plan.
+ * @throws std::runtime_error if no applicable plan fits; the message lists
+ * the smallest plan and its requirement.
+ */
+PlanEstimate select_plan(const PlanRequest &request, std::size_t budget_bytes);
+
+/**
+ * @brief Run the eigen decomposition of A with the given plan.
+ *
+ * As with `eigen_decomposition`, W receives the real parts of the
+ * eigenvalues. The Packed plan reads only the lower triangle of A and
+ * returns ascending eigenvalues with orthonormal eigenvectors; the InPlace
+ * plan overwrites A.
+ *
+ * @param plan The plan, usually from `select_plan`.
+ * @param A The square input matrix.
+ * @param W The vector that will store the computed eigenvalues.
+ * @param V The matrix that will store the computed eigenvectors; untouched
+ * if compute_vectors is false.
+ * @param compute_vectors Whether eigenvectors are computed (must be true for
+ * the Full plan, false for the ValuesOnly plan).
+ * @throws std::invalid_argument if A is not square or the plan does not
+ * match compute_vectors, std::runtime_error if LAPACK or the scratch file
+ * fails.
+ */
+void execute_plan(EigenPlan plan, Eigen::MatrixXd &A, Eigen::VectorXd &W,
+                  Eigen::MatrixXd &V, bool compute_vectors = true);
+
+/**
+ * @brief Peak memory of `singular_values` on an m x n matrix.
+ *
+ * The buffers stay leased by the calling thread's SVD context afterwards,
+ * so callers that compute singular values first should reserve this much
+ * in addition to the decomposition plan.
+ */
+std::size_t singular_values_bytes(Eigen::Index m, Eigen::Index n);
+
+#endif // MEMORY_PLANNER_H
@@ -0,0 +1,72 @@
+/**
+ * @file parallel.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the `parallel_for` executor.
+ */
+
+#include "parallel.h"
+#include "thread_affinity.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+unsigned default_thread_count()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void parallel_for(std::size_t count,
+                  const std::function<void(std::size_t, std::size_t)> &body,
+                  unsigned threads)
+{
+    if (count == 0)
+        return;
+    if (threads == 0)
+        threads = default_thread_count();
+    threads = static_cast<unsigned>(
+        std::min<std::size_t>(threads, count));
+    if (threads == 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    const std::size_t chunk = (count + threads - 1) / threads;
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    auto run_chunk = [&](unsigned t) {
+        const std::size_t begin = t * chunk;
+        const std::size_t end = std::min(count, begin + chunk);
+        if (begin >= end)
+            return;
+        try
+        {
+            body(begin, end);
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    for (unsigned t = 1; t < threads; ++t)
+    {
+        workers.emplace_back([&run_chunk, t] {
+            pin_team_thread(t);
+            run_chunk(t);
+        });
+    }
+    run_chunk(0);
+    for (auto &worker : workers)
+        worker.join();
+
+    for (const auto &error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,42 @@
+/**
+ * @file parallel.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the small thread executor used by the
+ * batched routines.
+ *
+ * `parallel_for` splits an index range into contiguous chunks and runs them
+ * on plain std::threads. It is deliberately minimal: the batched routines
+ * only need static partitioning of independent work items.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief Number of threads `parallel_for` uses when none is requested.
+ *
+ * @return std::thread::hardware_concurrency(), at least 1.
+ */
+unsigned default_thread_count();
+
+/**
+ * @brief Run body(begin, end) over [0, count) split into contiguous chunks.
+ *
+ * The calling thread processes the first chunk itself. Exceptions thrown by
+ * body are rethrown in the calling thread once all chunks have finished.
+ * Under a placement policy (see thread_affinity.h) worker thread t is
+ * pinned to the policy's t-th CPU.
+ *
+ * @param count The number of work items.
+ * @param body The function called with each half-open chunk [begin, end).
+ * @param threads The number of threads, 0 for `default_thread_count()`.
+ */
+void parallel_for(std::size_t count,
+                  const std::function<void(std::size_t, std::size_t)> &body,
+                  unsigned threads = 0);
+
+#endif // PARALLEL_H
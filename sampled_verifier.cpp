@@ -0,0 +1,364 @@
+/**
+ * @file sampled_verifier.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the sampled online verifier.
+ *
+ * The checker owns a short queue of samples and one worker thread. All of
+ * its state is guarded by one mutex, which the calling threads only take
+ * for sampled calls; the unsampled ones read two atomics.
+ */
+
+#include "sampled_verifier.h"
+#include "layout_convert.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#ifdef __APPLE__
+#include <pthread/qos.h>
+#endif
+
+namespace
+{
+
+/**
+ * @brief Samples waiting for the worker; more are dropped.
+ */
+constexpr std::size_t max_pending = 2;
+
+struct Pair
+{
+    double re;
+    double im;
+    Eigen::VectorXd x; ///< the eigenvector, or its real part
+    Eigen::VectorXd y; ///< its imaginary part; empty for a real eigenvalue
+};
+
+struct Sample
+{
+    Eigen::Index n;
+    std::vector<double> a;
+    std::vector<Pair> pairs;
+    double limit; ///< the largest accepted residual
+};
+
+/**
+ * @brief Move the calling thread to the lowest scheduling priority, so
+ * checks only use otherwise idle CPU time.
+ */
+void lower_priority()
+{
+#ifdef __linux__
+    sched_param param = {};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+#ifdef __APPLE__
+    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#endif
+}
+
+void check(const Sample &sample, VerifierStats &stats)
+{
+    const Eigen::Map<const Eigen::MatrixXd> A(sample.a.data(), sample.n,
+                                              sample.n);
+    // check_decomposition in main divides by ||A||_F as well; a zero A,
+    // where it gives 0/0, is measured in absolute terms
+    const double norm = A.norm();
+    const double scale = norm > 0.0 ? norm : 1.0;
+    for (const Pair &pair : sample.pairs)
+    {
+        // The eigenvector scaled to unit length, which dgeev's already are
+        // up to rounding; a zero vector gives a non-finite residual
+        const double length =
+            std::sqrt(pair.x.squaredNorm() + pair.y.squaredNorm());
+        const Eigen::VectorXd x = pair.x / length;
+        double residual;
+        if (pair.y.size() == 0)
+        {
+            residual = (A * x - pair.re * x).norm() / scale;
+        }
+        else
+        {
+            // (A - (re + i im) I)(x + i y) split into real and imaginary
+            // parts
+            const Eigen::VectorXd y = pair.y / length;
+            const Eigen::VectorXd real = A * x - pair.re * x + pair.im * y;
+            const Eigen::VectorXd imag = A * y - pair.im * x - pair.re * y;
+            residual =
+                std::sqrt(real.squaredNorm() + imag.squaredNorm()) / scale;
+        }
+        ++stats.pairs;
+        if (!std::isfinite(residual))
+        {
+            ++stats.anomalies;
+            ++stats.non_finite;
+            continue;
+        }
+        stats.worst_residual = std::max(stats.worst_residual, residual);
+        if (residual > sample.limit)
+            ++stats.anomalies;
+    }
+}
+
+class Checker
+{
+  public:
+    ~Checker()
+    {
+        stop();
+    }
+
+    void start(double fraction, unsigned pairs, double tolerance)
+    {
+        stop();
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_ = VerifierStats();
+        calls_.store(0);
+        pairs_ = pairs;
+        tolerance_ = tolerance;
+        stopping_ = false;
+        worker_ = std::thread([this] { run(); });
+        fraction_.store(fraction);
+        active_.store(true);
+    }
+
+    void stop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        active_.store(false);
+        if (!worker_.joinable())
+            return;
+        stopping_ = true;
+        lock.unlock();
+        changed_.notify_all();
+        worker_.join();
+    }
+
+    bool active() const
+    {
+        return active_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Count a call and decide whether to sample it.
+     */
+    bool sample_call()
+    {
+        thread_local std::mt19937_64 random(std::random_device{}());
+        const double fraction = fraction_.load(std::memory_order_relaxed);
+        calls_.fetch_add(1, std::memory_order_relaxed);
+        if (std::uniform_real_distribution<double>()(random) >= fraction)
+            return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.size() < max_pending)
+            return true;
+        ++stats_.dropped;
+        return false;
+    }
+
+    unsigned pairs()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pairs_;
+    }
+
+    void submit(Sample &&sample)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!active() || queue_.size() >= max_pending)
+            {
+                ++stats_.dropped;
+                return;
+            }
+            sample.limit = tolerance_ * static_cast<double>(sample.n) *
+                           std::numeric_limits<double>::epsilon();
+            queue_.push_back(std::move(sample));
+            ++stats_.sampled;
+        }
+        changed_.notify_all();
+    }
+
+    VerifierStats stats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        VerifierStats stats = stats_;
+        stats.calls = calls_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+  private:
+    void run()
+    {
+        lower_priority();
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            changed_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty())
+                return;
+            const Sample sample = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+            VerifierStats found;
+            check(sample, found);
+            lock.lock();
+            stats_.pairs += found.pairs;
+            stats_.anomalies += found.anomalies;
+            stats_.non_finite += found.non_finite;
+            stats_.worst_residual =
+                std::max(stats_.worst_residual, found.worst_residual);
+        }
+    }
+
+    std::atomic<bool> active_{false};
+    std::atomic<double> fraction_{0.0};
+    std::atomic<std::uint64_t> calls_{0};
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<Sample> queue_;     ///< guarded by mutex_
+    VerifierStats stats_;          ///< guarded by mutex_, except calls
+    unsigned pairs_ = 0;           ///< guarded by mutex_
+    double tolerance_ = 0.0;       ///< guarded by mutex_
+    bool stopping_ = false;        ///< guarded by mutex_
+    std::thread worker_;
+};
+
+Checker checker;
+
+void start_checker(double fraction, unsigned pairs, double tolerance)
+{
+    if (!(fraction > 0.0 && fraction <= 1.0))
+        throw std::invalid_argument(
+            "start_verifier: the fraction must be in (0, 1]");
+    if (pairs == 0)
+        throw std::invalid_argument("start_verifier: pairs must be positive");
+    if (!(tolerance > 0.0))
+        throw std::invalid_argument(
+            "start_verifier: the tolerance must be positive");
+    checker.start(fraction, pairs, tolerance);
+}
+
+void report_at_exit()
+{
+    stop_verifier();
+    std::cerr << "EIGEN_VERIFY: " << verifier_stats() << std::endl;
+}
+
+bool start_from_environment()
+{
+    const char *fraction = std::getenv("EIGEN_VERIFY");
+    if (fraction == nullptr || *fraction == '\0')
+        return false;
+    const char *pairs = std::getenv("EIGEN_VERIFY_PAIRS");
+    try
+    {
+        start_checker(std::strtod(fraction, nullptr),
+                      pairs != nullptr ? std::strtoul(pairs, nullptr, 10)
+                                       : 4,
+                      100.0);
+        std::atexit(report_at_exit);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "EIGEN_VERIFY: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool environment_checked()
+{
+    static const bool started = start_from_environment();
+    return started;
+}
+
+} // namespace
+
+void start_verifier(double fraction, unsigned pairs, double tolerance)
+{
+    environment_checked();
+    start_checker(fraction, pairs, tolerance);
+}
+
+void stop_verifier()
+{
+    environment_checked();
+    checker.stop();
+}
+
+bool verifier_active()
+{
+    environment_checked();
+    return checker.active();
+}
+
+VerifierStats verifier_stats()
+{
+    return checker.stats();
+}
+
+std::ostream &operator<<(std::ostream &out, const VerifierStats &stats)
+{
+    return out << "calls=" << stats.calls << " sampled=" << stats.sampled
+               << " dropped=" << stats.dropped << " pairs=" << stats.pairs
+               << " anomalies=" << stats.anomalies
+               << " non_finite=" << stats.non_finite
+               << " worst_residual=" << stats.worst_residual;
+}
+
+VerifyCallScope::VerifyCallScope(const double *a, Eigen::Index n,
+                                 Eigen::Index lda)
+    : n_(n)
+{
+    if (n == 0 || !verifier_active() || !checker.sample_call())
+        return;
+    a_.resize(static_cast<std::size_t>(n) * n);
+    copy_matrix(a, lda, n, n, a_.data(), n, 1);
+    sampled_ = true;
+}
+
+void VerifyCallScope::done(const double *wr, const double *wi,
+                           const double *v, Eigen::Index ldv)
+{
+    if (!sampled_)
+        return;
+    sampled_ = false;
+    thread_local std::mt19937_64 random(std::random_device{}());
+    std::uniform_int_distribution<Eigen::Index> pick(0, n_ - 1);
+    const unsigned pairs = checker.pairs();
+
+    Sample sample{n_, std::move(a_), {}, 0.0};
+    std::vector<Eigen::Index> chosen;
+    for (Eigen::Index t = 0; t < pairs && t < n_; ++t)
+    {
+        Eigen::Index j = pick(random);
+        // dgeev stores a complex pair in columns j (real part) and j + 1
+        // (imaginary part), the eigenvalue with positive imaginary part
+        // first
+        if (wi[j] < 0.0 && j > 0)
+            --j;
+        if (std::find(chosen.begin(), chosen.end(), j) != chosen.end())
+            continue;
+        chosen.push_back(j);
+        Pair pair{wr[j], wi[j],
+                  Eigen::Map<const Eigen::VectorXd>(v + j * ldv, n_), {}};
+        if (wi[j] != 0.0 && j + 1 < n_)
+            pair.y = Eigen::Map<const Eigen::VectorXd>(v + (j + 1) * ldv, n_);
+        sample.pairs.push_back(std::move(pair));
+    }
+    checker.submit(std::move(sample));
+}
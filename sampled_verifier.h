@@ -0,0 +1,125 @@
+/**
+ * @file sampled_verifier.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the sampled online verifier of the
+ * eigenvalue decomposition.
+ *
+ * Checking a whole decomposition (as main's reconstruction check does)
+ * costs more than computing it, so production code cannot afford it on
+ * every call. The verifier checks a random fraction of the
+ * `eigen_decomposition` calls instead, and of each sampled call only k
+ * random eigenpairs (lambda, v), by their relative residual
+ *
+ *     ||A v - lambda v|| / ||A||_F   with ||v|| = 1,
+ *
+ * which costs O(n^2 k) rather than O(n^3). This is main's reconstruction
+ * error ||A - V W V^-1||_F / ||A||_F with the same normalization, taken
+ * over one column of A V - V W: for a normal A, whose V is unitary, the
+ * squared residuals of all n eigenpairs add up to the squared
+ * reconstruction error, so the two can be compared directly. A complex
+ * pair is checked as one eigenpair through its real and imaginary parts,
+ * with x + i y of unit length. A residual above
+ * tolerance * n * machine epsilon, or a non-finite eigenvalue or vector,
+ * counts as an anomaly.
+ *
+ * The calling thread only copies A for the sampled calls (before LAPACK
+ * overwrites it) and the chosen eigenpairs after; the residuals are
+ * computed by a background thread at idle priority. Samples that arrive
+ * while that thread is still busy with earlier ones are dropped, so the
+ * verifier never blocks a caller nor holds more than a few matrices.
+ *
+ * When no verifier runs it costs one atomic load per call. It is started
+ * with `start_verifier`, or for an unmodified program by setting
+ * EIGEN_VERIFY=<fraction> (and EIGEN_VERIFY_PAIRS=<k>) in the environment;
+ * such a verifier prints its counters to stderr at exit.
+ */
+
+#ifndef SAMPLED_VERIFIER_H
+#define SAMPLED_VERIFIER_H
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief The counters of a verifier since it was started.
+ */
+struct VerifierStats
+{
+    std::uint64_t calls = 0;      ///< decompositions seen
+    std::uint64_t sampled = 0;    ///< calls whose eigenpairs were checked
+    std::uint64_t dropped = 0;    ///< samples skipped, the checker was busy
+    std::uint64_t pairs = 0;      ///< eigenpairs checked
+    std::uint64_t anomalies = 0;  ///< eigenpairs above the tolerance
+    std::uint64_t non_finite = 0; ///< anomalies with NaN or Inf in them
+    double worst_residual = 0.0;  ///< largest finite relative residual
+};
+
+/**
+ * @brief Start verifying a fraction of the calls, replacing a running
+ * verifier.
+ *
+ * @param fraction The probability that a call is sampled, in (0, 1].
+ * @param pairs The number of eigenpairs checked per sampled call.
+ * @param tolerance The largest accepted residual in units of n * machine
+ * epsilon.
+ * @throws std::invalid_argument for a fraction outside (0, 1], no pairs or
+ * a tolerance that is not positive.
+ */
+void start_verifier(double fraction, unsigned pairs = 4,
+                    double tolerance = 100.0);
+
+/**
+ * @brief Finish the queued checks and stop verifying.
+ */
+void stop_verifier();
+
+/**
+ * @brief Whether a verifier is running.
+ *
+ * The first call starts a verifier configured by EIGEN_VERIFY if it is set.
+ */
+bool verifier_active();
+
+/**
+ * @brief The counters of the running (or last) verifier.
+ */
+VerifierStats verifier_stats();
+
+/**
+ * @brief Print counters as one line of "name=value" fields.
+ */
+std::ostream &operator<<(std::ostream &out, const VerifierStats &stats);
+
+/**
+ * @brief Samples one `dgeev` call of the interface if a verifier runs.
+ *
+ * Construct it with the LAPACK input right before the call (the input may
+ * be destroyed by it) and call `done` with the results once it succeeded;
+ * a call that throws is not checked.
+ */
+class VerifyCallScope
+{
+  public:
+    VerifyCallScope(const double *a, Eigen::Index n, Eigen::Index lda);
+
+    /**
+     * @brief Queue the check of the sampled call.
+     *
+     * @param wr The real parts of the eigenvalues.
+     * @param wi The imaginary parts of the eigenvalues.
+     * @param v The eigenvectors as returned by `dgeev`, leading dimension
+     * ldv.
+     */
+    void done(const double *wr, const double *wi, const double *v,
+              Eigen::Index ldv);
+
+  private:
+    bool sampled_ = false;
+    Eigen::Index n_;
+    std::vector<double> a_; ///< the copy of A, n x n
+};
+
+#endif // SAMPLED_VERIFIER_H
@@ -0,0 +1,111 @@
+/**
+ * @file solver_control.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines cooperative cancellation and progress
+ * reporting for the iterative and batched solvers.
+ *
+ * A solver that takes a `SolverControl` checks it once per iteration (or
+ * restart, or block of a batch): a relaxed atomic load and, if a progress
+ * callback is set, one call, which is negligible next to the O(n^2) or more
+ * work of an iteration. The callback sees the number of converged pairs and
+ * the current residual and can stop the solver once the accuracy is good
+ * enough.
+ *
+ * Typical use:
+ * @code
+ * CancellationToken token; // token.cancel() from another thread
+ * SolverControl control;
+ * control.cancel = &token;
+ * control.progress = [](const SolverProgress &p) {
+ *     return p.max_residual > 1e-6; // stop once 1e-6 is reached
+ * };
+ * subspace_iteration(A, 10, W, V, 1e-12, 1000, control);
+ * @endcode
+ */
+
+#ifndef SOLVER_CONTROL_H
+#define SOLVER_CONTROL_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Thrown by a solver whose cancellation token was triggered.
+ */
+class OperationCancelled : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief A flag, set once from any thread, that asks solvers to stop.
+ */
+class CancellationToken
+{
+  public:
+    void cancel() noexcept
+    {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    bool cancelled() const noexcept
+    {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<bool> cancelled_{false};
+};
+
+/**
+ * @brief The state of a solver passed to the progress callback.
+ */
+struct SolverProgress
+{
+    int iteration = 0;         ///< iterations (or blocks) done so far
+    std::size_t converged = 0; ///< converged eigenpairs (or matrices)
+    std::size_t wanted = 0;    ///< eigenpairs (or matrices) requested
+    double max_residual = 0.0; ///< largest relative residual of those wanted
+};
+
+/**
+ * @brief Cancellation and progress reporting for one solver call.
+ *
+ * Both members are optional. The callback returns false to stop the
+ * solver: iterative solvers then return their current approximation,
+ * batched solvers throw `OperationCancelled`, since a partly decomposed
+ * batch is of no use. Batched solvers report once per finished block of
+ * matrices and never call the callback concurrently.
+ */
+struct SolverControl
+{
+    const CancellationToken *cancel = nullptr;
+    std::function<bool(const SolverProgress &)> progress;
+
+    /**
+     * @brief Throws `OperationCancelled` if the token was triggered.
+     */
+    void check_cancelled(const char *solver) const
+    {
+        if (cancel != nullptr && cancel->cancelled())
+            throw OperationCancelled(std::string(solver) + " was cancelled");
+    }
+
+    /**
+     * @brief Check the token, then report progress.
+     *
+     * @return false if the callback asked the solver to stop.
+     */
+    bool report(const char *solver, const SolverProgress &state) const
+    {
+        check_cancelled(solver);
+        return !progress || progress(state);
+    }
+};
+
+#endif // SOLVER_CONTROL_H
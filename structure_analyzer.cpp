@@ -0,0 +1,172 @@
+/**
+ * @file structure_analyzer.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the structure analysis.
+ */
+
+#include "structure_analyzer.h"
+#include "parallel.h"
+#include "workspace_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+
+/**
+ * @brief Matrices from this many elements on are analyzed in parallel.
+ */
+constexpr std::size_t parallel_elements = std::size_t(1) << 20;
+
+/**
+ * @brief Scan columns [begin, end) into profile, marking the rows with a
+ * nonzero entry in used.
+ */
+void scan_columns(const double *a, std::size_t m, std::size_t n,
+                  std::size_t lda, std::size_t begin, std::size_t end,
+                  StructureProfile &profile, unsigned char *used)
+{
+    for (std::size_t j = begin; j < end; ++j)
+    {
+        const double *col = a + j * lda;
+        // x * 0 is NaN exactly for a NaN or infinite x
+        double poison = 0.0;
+        std::size_t first = m;
+        std::size_t last = 0;
+        std::size_t nonzeros = 0;
+#pragma omp simd reduction(+ : poison, nonzeros) reduction(min : first) \
+    reduction(max : last)
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            const double x = col[i];
+            const bool nonzero = x != 0.0;
+            poison += x * 0.0;
+            used[i] |= nonzero;
+            nonzeros += nonzero;
+            first = nonzero && i < first ? i : first;
+            last = nonzero && i > last ? i : last;
+        }
+        if (poison != 0.0)
+            profile.finite = false;
+        if (nonzeros == 0)
+        {
+            ++profile.zero_cols;
+        }
+        else
+        {
+            if (last > j)
+                profile.lower_bandwidth =
+                    std::max(profile.lower_bandwidth, last - j);
+            if (first < j)
+                profile.upper_bandwidth =
+                    std::max(profile.upper_bandwidth, j - first);
+        }
+
+        if (!profile.symmetric && !profile.skew_symmetric)
+            continue;
+        // The part of column j below the diagonal against the part of row
+        // j right of it
+        int symmetric = 1;
+        int skew = col[j] == 0.0;
+        const double *row = a + j;
+#pragma omp simd reduction(& : symmetric, skew)
+        for (std::size_t i = j + 1; i < n; ++i)
+        {
+            const double x = col[i];
+            const double y = row[i * lda];
+            symmetric &= x == y;
+            skew &= x == -y;
+        }
+        profile.symmetric = profile.symmetric && symmetric;
+        profile.skew_symmetric = profile.skew_symmetric && skew;
+    }
+}
+
+/**
+ * @brief The number of chunks an analysis of m x n runs in.
+ */
+unsigned chunk_count(std::size_t m, std::size_t n, unsigned threads)
+{
+    if (threads == 0)
+        threads = m * n >= parallel_elements ? default_thread_count() : 1;
+    return static_cast<unsigned>(
+        std::min<std::size_t>(threads, std::max<std::size_t>(n, 1)));
+}
+
+/**
+ * @brief The bytes of the row flags leased for the chunks.
+ */
+std::size_t flags_bytes(std::size_t m, unsigned chunks)
+{
+    return std::max<std::size_t>(1, static_cast<std::size_t>(chunks) * m);
+}
+
+} // namespace
+
+StructureProfile analyze_structure(const double *a, std::size_t m,
+                                   std::size_t n, std::size_t lda,
+                                   unsigned threads)
+{
+    threads = chunk_count(m, n, threads);
+
+    // One row of flags per chunk, leased like the LAPACK workspaces so that
+    // the analysis allocates nothing once the pool is warm
+    WorkspaceLease scratch =
+        WorkspacePool::instance().acquire(flags_bytes(m, threads));
+    unsigned char *flags = reinterpret_cast<unsigned char *>(scratch.data());
+    std::atomic<unsigned> chunks{0};
+
+    // Only square matrices can be symmetric; the chunks start from this
+    // rather than reading merged, which the others update under the lock
+    const bool square = m == n;
+    StructureProfile merged;
+    merged.symmetric = square;
+    merged.skew_symmetric = square;
+    std::mutex mutex;
+    parallel_for(
+        n,
+        [&](std::size_t begin, std::size_t end) {
+            unsigned char *used = flags + chunks.fetch_add(1) * m;
+            std::fill(used, used + m, 0);
+            StructureProfile profile;
+            profile.symmetric = square;
+            profile.skew_symmetric = square;
+            scan_columns(a, m, n, lda, begin, end, profile, used);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            merged.finite = merged.finite && profile.finite;
+            merged.symmetric = merged.symmetric && profile.symmetric;
+            merged.skew_symmetric =
+                merged.skew_symmetric && profile.skew_symmetric;
+            merged.lower_bandwidth =
+                std::max(merged.lower_bandwidth, profile.lower_bandwidth);
+            merged.upper_bandwidth =
+                std::max(merged.upper_bandwidth, profile.upper_bandwidth);
+            merged.zero_cols += profile.zero_cols;
+        },
+        threads);
+
+    // Fold the other chunks' rows into the first one's
+    for (unsigned c = 1; c < chunks.load(); ++c)
+    {
+        const unsigned char *used = flags + c * m;
+#pragma omp simd
+        for (std::size_t i = 0; i < m; ++i)
+            flags[i] |= used[i];
+    }
+    // Without columns every row is zero
+    merged.zero_rows = chunks.load() == 0
+                           ? m
+                           : static_cast<std::size_t>(
+                                 std::count(flags, flags + m, 0));
+    return merged;
+}
+
+std::size_t analyze_structure_bytes(std::size_t m, std::size_t n,
+                                    unsigned threads)
+{
+    return WorkspacePool::class_bytes(WorkspacePool::size_class(
+        flags_bytes(m, chunk_count(m, n, threads))));
+}
@@ -0,0 +1,74 @@
+/**
+ * @file structure_analyzer.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the structure analysis that runs before
+ * every general eigenvalue decomposition.
+ *
+ * `dgeev` spends O(n^3) on any input, even on ones whose eigenvalues can be
+ * read off the diagonal, and on a matrix with a NaN in it it iterates until
+ * the QR sweeps give up. `analyze_structure` finds out in one O(n^2) pass
+ * what the matrix is: every column is read once, with `#pragma omp simd`
+ * reductions, and large matrices are split by columns over `parallel_for`
+ * threads whose partial results are merged at the end. The symmetry checks
+ * also read the transposed element; they stop once both have failed, which
+ * for a general matrix is within the first column.
+ *
+ * The call trace (see trace_recorder.h) records the structure found by the
+ * same pass rather than scanning the matrix again.
+ */
+
+#ifndef STRUCTURE_ANALYZER_H
+#define STRUCTURE_ANALYZER_H
+
+#include <cstddef>
+
+/**
+ * @brief What one pass over a matrix found.
+ */
+struct StructureProfile
+{
+    bool finite = true;              ///< no NaN or Inf entry
+    bool symmetric = true;           ///< square and a_ij == a_ji
+    bool skew_symmetric = true;      ///< square, a_ij == -a_ji, a_ii == 0
+    std::size_t lower_bandwidth = 0; ///< largest i - j of a nonzero a_ij
+    std::size_t upper_bandwidth = 0; ///< largest j - i of a nonzero a_ij
+    std::size_t zero_rows = 0;       ///< rows without a nonzero entry
+    std::size_t zero_cols = 0;       ///< columns without a nonzero entry
+
+    bool diagonal() const
+    {
+        return lower_bandwidth == 0 && upper_bandwidth == 0;
+    }
+
+    bool upper_triangular() const
+    {
+        return lower_bandwidth == 0;
+    }
+
+    bool lower_triangular() const
+    {
+        return upper_bandwidth == 0;
+    }
+};
+
+/**
+ * @brief Analyze an m x n column-major matrix with leading dimension lda.
+ *
+ * The symmetry flags are only meaningful for a finite matrix.
+ *
+ * @param threads The number of threads; 0 uses `default_thread_count()`
+ * for matrices of 2^20 elements or more and one thread below that.
+ */
+StructureProfile analyze_structure(const double *a, std::size_t m,
+                                   std::size_t n, std::size_t lda,
+                                   unsigned threads = 0);
+
+/**
+ * @brief The bytes `analyze_structure` leases from the workspace pool for
+ * an m x n matrix: one row of flags per thread, rounded to the size class.
+ */
+std::size_t analyze_structure_bytes(std::size_t m, std::size_t n,
+                                    unsigned threads = 0);
+
+#endif // STRUCTURE_ANALYZER_H
@@ -0,0 +1,105 @@
+/**
+ * @file subspace_iteration.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the subspace iteration solver.
+ */
+
+#include "subspace_iteration.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief An orthonormal basis of the columns of X.
+ */
+Eigen::MatrixXd orthonormalize(const Eigen::MatrixXd &X)
+{
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(X);
+    return qr.householderQ() * Eigen::MatrixXd::Identity(X.rows(), X.cols());
+}
+
+} // namespace
+
+SolverStatus subspace_iteration(const Eigen::MatrixXd &A, int k,
+                                Eigen::VectorXd &W, Eigen::MatrixXd &V,
+                                double tol, int max_iterations,
+                                const SolverControl &control)
+{
+    const char *solver = "subspace_iteration";
+    if (A.rows() != A.cols())
+    {
+        throw std::invalid_argument(
+            "subspace_iteration: matrix is not square");
+    }
+    const Eigen::Index n = A.rows();
+    if (k < 1 || k > n)
+    {
+        throw std::invalid_argument("subspace_iteration: k = " +
+                                    std::to_string(k) +
+                                    " is not in [1, n = " +
+                                    std::to_string(n) + "]");
+    }
+    const Eigen::Index p = std::min<Eigen::Index>(n, 2 * k + 8);
+
+    Eigen::MatrixXd Q = orthonormalize(Eigen::MatrixXd::Random(n, p));
+    Eigen::MatrixXd Z(n, p), H(p, p), S(p, p), X(n, p), AX(n, p);
+    Eigen::VectorXd theta(p);
+    std::vector<Eigen::Index> order(p);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> projected;
+
+    for (int iteration = 1; iteration <= max_iterations; ++iteration)
+    {
+        // Rayleigh-Ritz on span(Q)
+        Z.noalias() = A.selfadjointView<Eigen::Lower>() * Q;
+        H.noalias() = Q.transpose() * Z;
+        projected.compute(H, Eigen::ComputeEigenvectors);
+
+        // Dominant pairs first
+        std::iota(order.begin(), order.end(), Eigen::Index(0));
+        const Eigen::VectorXd &values = projected.eigenvalues();
+        std::sort(order.begin(), order.end(),
+                  [&](Eigen::Index a, Eigen::Index b) {
+                      return std::abs(values(a)) > std::abs(values(b));
+                  });
+        for (Eigen::Index j = 0; j < p; ++j)
+        {
+            theta(j) = values(order[j]);
+            S.col(j) = projected.eigenvectors().col(order[j]);
+        }
+        X.noalias() = Q * S;
+        AX.noalias() = Z * S;
+
+        // Converged pairs are counted from the dominant end
+        const double scale = std::max(std::abs(theta(0)), 1e-300);
+        SolverProgress state;
+        state.iteration = iteration;
+        state.wanted = static_cast<std::size_t>(k);
+        bool leading = true;
+        for (int j = 0; j < k; ++j)
+        {
+            const double residual =
+                (AX.col(j) - theta(j) * X.col(j)).norm() / scale;
+            state.max_residual = std::max(state.max_residual, residual);
+            leading = leading && residual <= tol;
+            if (leading)
+                ++state.converged;
+        }
+        W = theta.head(k);
+        V = X.leftCols(k);
+
+        const bool go_on = control.report(solver, state);
+        if (state.converged == state.wanted)
+            return SolverStatus::Converged;
+        if (!go_on)
+            return SolverStatus::Stopped;
+
+        Q = orthonormalize(AX);
+    }
+    return SolverStatus::NotConverged;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file subspace_iteration.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines a subspace iteration solver for a few
+ * dominant eigenpairs of a large symmetric matrix.
+ *
+ * `dgeev` and `dspev` always compute all n eigenpairs at O(n^3) cost. When
+ * only the k eigenvalues of largest magnitude are needed, subspace
+ * iteration with Rayleigh-Ritz projection gets them with matrix products on
+ * an n x p block (p a little larger than k), at O(n^2 p) per iteration.
+ */
+
+#ifndef SUBSPACE_ITERATION_H
+#define SUBSPACE_ITERATION_H
+
+#include "solver_control.h"
+#include <Eigen/Dense>
+
+/**
+ * @brief How an iterative solver finished.
+ */
+enum class SolverStatus
+{
+    Converged,   ///< all wanted pairs reached the tolerance
+    Stopped,     ///< the progress callback stopped the solver early
+    NotConverged ///< max_iterations were used up
+};
+
+/**
+ * @brief The k eigenvalues of largest magnitude of a symmetric matrix and
+ * their eigenvectors, by subspace iteration.
+ *
+ * Only the lower triangle of A is read. The iteration uses a block of
+ * p = min(n, 2k + 8) vectors. A pair counts as converged once its relative
+ * residual ||A v - w v|| / |w_max| drops below tol. Progress is reported
+ * after every iteration, with the number of leading pairs converged so far.
+ *
+ * @param A The symmetric input matrix.
+ * @param k The number of eigenpairs, 1 <= k <= n.
+ * @param W The vector that will store the eigenvalues, by decreasing
+ * magnitude.
+ * @param V The matrix that will store the eigenvectors (n x k).
+ * @param tol The relative residual tolerance.
+ * @param max_iterations The maximum number of iterations.
+ * @param control Cancellation and progress reporting.
+ * @return Whether the pairs converged, the solver was stopped or ran out of
+ * iterations; W and V hold the current approximation in every case.
+ * @throws std::invalid_argument if A is not square or k is out of range,
+ * `OperationCancelled` if the token was triggered.
+ */
+SolverStatus subspace_iteration(const Eigen::MatrixXd &A, int k,
+                                Eigen::VectorXd &W, Eigen::MatrixXd &V,
+                                double tol = 1e-10, int max_iterations = 1000,
+                                const SolverControl &control = {});
+
+#endif // SUBSPACE_ITERATION_H
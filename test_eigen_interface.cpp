@@ -0,0 +1,83 @@
+/**
+ * @file test_eigen_interface.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief Checks of the argument validation of the eigen interface.
+ *
+ * Every entry point must reject input LAPACK would read out of bounds
+ * before calling it. Run with `make test`.
+ */
+
+#include "eigen_interface.h"
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+int failures = 0;
+
+/**
+ * @brief Record a failure unless call throws std::invalid_argument.
+ */
+void expect_invalid_argument(const std::string &name,
+                             const std::function<void()> &call)
+{
+    try
+    {
+        call();
+    }
+    catch (const std::invalid_argument &)
+    {
+        return;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "FAIL " << name << ": threw " << e.what() << std::endl;
+        ++failures;
+        return;
+    }
+    std::cerr << "FAIL " << name << ": did not throw" << std::endl;
+    ++failures;
+}
+
+void test_hermitian_rejects_non_square()
+{
+    // Fewer columns than rows: LAPACK would touch n x n elements of a
+    // 6 x 4 buffer
+    const Eigen::MatrixXcd A = Eigen::MatrixXcd::Random(6, 4);
+    Eigen::VectorXd W;
+    Eigen::MatrixXcd V;
+    expect_invalid_argument("hermitian_eigen_decomposition", [&] {
+        hermitian_eigen_decomposition(A, W, V);
+    });
+    expect_invalid_argument("hermitian_eigen_decomposition_inplace", [&] {
+        Eigen::MatrixXcd B = A;
+        hermitian_eigen_decomposition_inplace(B, W);
+    });
+    expect_invalid_argument("hermitian_eigenvalues",
+                            [&] { hermitian_eigenvalues(A, W); });
+    expect_invalid_argument("hermitian_eigen_subset",
+                            [&] { hermitian_eigen_subset(A, 0, 1, W, V); });
+}
+
+} // namespace
+
+/**
+ * @brief The main entry point of the checks.
+ *
+ * @return Returns 0 if all checks passed, 1 otherwise.
+ */
+int main()
+{
+    test_hermitian_rejects_non_square();
+    if (failures != 0)
+    {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,253 @@
+/**
+ * @file thread_affinity.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the thread placement
+ * policies.
+ *
+ * The topology comes from /sys/devices/system/cpu/cpuN/topology: the
+ * package and core ids of every CPU the process may run on. The SMT index
+ * of a CPU is its rank among the CPUs of the same core.
+ */
+
+#include "thread_affinity.h"
+#include "blas_threads.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace
+{
+
+std::mutex policy_mutex;
+std::vector<int> current_cpus; ///< guarded by policy_mutex
+std::atomic<bool> pinning{false};
+
+#ifdef __linux__
+
+struct Cpu
+{
+    int id;
+    int package;
+    int core;
+    int smt = 0;
+    int core_rank = 0; ///< index of the core within its package
+};
+
+cpu_set_t &original_mask()
+{
+    // The CPU set of the first caller, before any pinning
+    static cpu_set_t mask = [] {
+        cpu_set_t m;
+        CPU_ZERO(&m);
+        sched_getaffinity(0, sizeof m, &m);
+        return m;
+    }();
+    return mask;
+}
+
+int read_id(int cpu, const char *file)
+{
+    std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                     "/topology/" + file);
+    int id = 0;
+    in >> id;
+    return id;
+}
+
+std::vector<Cpu> topology()
+{
+    const cpu_set_t &allowed = original_mask();
+    std::vector<Cpu> cpus;
+    for (int id = 0; id < CPU_SETSIZE; ++id)
+    {
+        if (CPU_ISSET(id, &allowed))
+        {
+            cpus.push_back({id, read_id(id, "physical_package_id"),
+                            read_id(id, "core_id")});
+        }
+    }
+
+    std::map<std::pair<int, int>, int> smt;
+    std::map<int, std::map<int, int>> cores; // package -> core -> rank
+    for (Cpu &c : cpus)
+    {
+        c.smt = smt[{c.package, c.core}]++;
+        cores[c.package].emplace(c.core, 0);
+    }
+    for (auto &package : cores)
+    {
+        int rank = 0;
+        for (auto &core : package.second)
+            core.second = rank++;
+    }
+    for (Cpu &c : cpus)
+        c.core_rank = cores[c.package][c.core];
+    return cpus;
+}
+
+bool pin(pid_t tid, const cpu_set_t &mask)
+{
+    return sched_setaffinity(tid, sizeof mask, &mask) == 0;
+}
+
+bool pin(pid_t tid, int cpu)
+{
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    return pin(tid, mask);
+}
+
+/**
+ * @brief The CPUs of a mask, in increasing order.
+ */
+std::vector<int> mask_cpus(const cpu_set_t &mask)
+{
+    std::vector<int> cpus;
+    for (int id = 0; id < CPU_SETSIZE; ++id)
+    {
+        if (CPU_ISSET(id, &mask))
+            cpus.push_back(id);
+    }
+    return cpus;
+}
+
+#endif
+
+} // namespace
+
+const char *policy_name(AffinityPolicy policy)
+{
+    switch (policy)
+    {
+    case AffinityPolicy::None:
+        return "none";
+    case AffinityPolicy::Compact:
+        return "compact";
+    case AffinityPolicy::Scatter:
+        return "scatter";
+    case AffinityPolicy::PhysicalCores:
+        return "physical";
+    case AffinityPolicy::Explicit:
+        return "explicit";
+    }
+    return "unknown";
+}
+
+AffinityPolicy parse_affinity_policy(const std::string &name)
+{
+    for (AffinityPolicy policy :
+         {AffinityPolicy::None, AffinityPolicy::Compact,
+          AffinityPolicy::Scatter, AffinityPolicy::PhysicalCores,
+          AffinityPolicy::Explicit})
+    {
+        if (name == policy_name(policy))
+            return policy;
+    }
+    throw std::invalid_argument("unknown placement policy: " + name);
+}
+
+std::vector<int> placement_cpus(const PlacementPolicy &policy)
+{
+    std::vector<int> order;
+#ifdef __linux__
+    if (policy.policy == AffinityPolicy::None)
+        return order;
+    if (policy.policy == AffinityPolicy::Explicit)
+    {
+        for (int cpu : policy.cpus)
+        {
+            if (cpu < 0 || cpu >= CPU_SETSIZE ||
+                !CPU_ISSET(cpu, &original_mask()))
+            {
+                throw std::invalid_argument("placement_cpus: CPU " +
+                                            std::to_string(cpu) +
+                                            " is not available");
+            }
+        }
+        return policy.cpus;
+    }
+
+    std::vector<Cpu> cpus = topology();
+    if (policy.policy == AffinityPolicy::PhysicalCores)
+    {
+        cpus.erase(std::remove_if(cpus.begin(), cpus.end(),
+                                  [](const Cpu &c) { return c.smt > 0; }),
+                   cpus.end());
+    }
+    if (policy.policy == AffinityPolicy::Scatter)
+    {
+        std::sort(cpus.begin(), cpus.end(), [](const Cpu &a, const Cpu &b) {
+            return std::tie(a.smt, a.core_rank, a.package) <
+                   std::tie(b.smt, b.core_rank, b.package);
+        });
+    }
+    else
+    {
+        std::sort(cpus.begin(), cpus.end(), [](const Cpu &a, const Cpu &b) {
+            return std::tie(a.package, a.core, a.smt) <
+                   std::tie(b.package, b.core, b.smt);
+        });
+    }
+    for (const Cpu &c : cpus)
+        order.push_back(c.id);
+#else
+    if (policy.policy == AffinityPolicy::Explicit)
+        order = policy.cpus;
+#endif
+    return order;
+}
+
+bool apply_placement(const PlacementPolicy &policy)
+{
+    const std::vector<int> cpus = placement_cpus(policy);
+    {
+        std::lock_guard<std::mutex> lock(policy_mutex);
+        current_cpus = cpus;
+        pinning.store(!cpus.empty());
+    }
+#ifdef __linux__
+    // The BLAS workers are threads 1, 2, ... of their team, the thread
+    // calling into BLAS being thread 0
+    const unsigned workers = blas_threads() > 1 ? blas_threads() - 1 : 0;
+    bool ok = true;
+    if (cpus.empty())
+    {
+        const std::vector<int> all = mask_cpus(original_mask());
+        for (unsigned w = 0; w < workers; ++w)
+            pin_blas_worker(w, all);
+        return policy.policy == AffinityPolicy::None;
+    }
+    for (unsigned w = 0; w < workers; ++w)
+        ok = pin_blas_worker(w, {cpus[(w + 1) % cpus.size()]}) && ok;
+    return ok;
+#else
+    return false;
+#endif
+}
+
+void pin_team_thread(unsigned t)
+{
+    if (!pinning.load(std::memory_order_relaxed))
+        return;
+#ifdef __linux__
+    int cpu;
+    {
+        std::lock_guard<std::mutex> lock(policy_mutex);
+        if (current_cpus.empty())
+            return;
+        cpu = current_cpus[t % current_cpus.size()];
+    }
+    pin(0, cpu);
+#else
+    (void)t;
+#endif
+}
@@ -0,0 +1,100 @@
+/**
+ * @file thread_affinity.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the placement policies that pin solver
+ * threads to CPUs.
+ *
+ * Unpinned, the threads of `parallel_for` and of the BLAS team migrate
+ * between cores and share cores with their SMT siblings, which makes run
+ * times vary by tens of percent. A placement policy fixes the CPU of every
+ * thread:
+ * - Compact fills a core's SMT siblings before moving to the next core, and
+ *   a package before the next package (shared caches);
+ * - Scatter spreads threads over packages, then over cores, and uses SMT
+ *   siblings last (memory bandwidth);
+ * - PhysicalCores uses one hardware thread per core, in compact order;
+ * - Explicit uses a given list of CPUs.
+ * Thread t of a team runs on the t-th CPU of the policy's list (wrapping
+ * around if there are more threads than CPUs). Pinning is only supported on
+ * Linux; elsewhere the policy is recorded but has no effect.
+ */
+
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief How threads are placed on CPUs.
+ */
+enum class AffinityPolicy
+{
+    None, ///< no pinning, the scheduler decides
+    Compact,
+    Scatter,
+    PhysicalCores,
+    Explicit
+};
+
+/**
+ * @brief A placement policy, with the CPU list for `AffinityPolicy::Explicit`.
+ */
+struct PlacementPolicy
+{
+    AffinityPolicy policy = AffinityPolicy::None;
+    std::vector<int> cpus; ///< only used by Explicit
+};
+
+/**
+ * @brief The name of a policy: "none", "compact", "scatter", "physical" or
+ * "explicit".
+ */
+const char *policy_name(AffinityPolicy policy);
+
+/**
+ * @brief The policy with the given name.
+ *
+ * @throws std::invalid_argument if the name is unknown.
+ */
+AffinityPolicy parse_affinity_policy(const std::string &name);
+
+/**
+ * @brief The CPUs of a policy in the order threads are placed on them.
+ *
+ * Only CPUs the process may run on are included. Empty for None, or if the
+ * topology cannot be read.
+ *
+ * @throws std::invalid_argument if an explicit list names a CPU the process
+ * may not run on.
+ */
+std::vector<int> placement_cpus(const PlacementPolicy &policy);
+
+/**
+ * @brief Make a policy the current one and apply it to the solver threads.
+ *
+ * Only threads that work for the library are pinned: the `parallel_for`
+ * workers pin themselves to CPU t of the policy when they start, and the
+ * running workers of the BLAS team are pinned to CPUs 1, 2, ... through
+ * the BLAS library's own interface (see `pin_blas_worker`). The calling
+ * thread, which runs the first chunk of a team and calls into BLAS, is left
+ * alone, as are all other threads of the host program; pin it to CPU 0
+ * yourself if wanted. Size the BLAS team (`set_blas_threads`) and start it
+ * (`warmup`) before applying a policy. None restores the CPU set the
+ * process started with for the BLAS workers.
+ *
+ * @return false if pinning is not supported, or the BLAS team has workers
+ * that could not be pinned.
+ */
+bool apply_placement(const PlacementPolicy &policy);
+
+/**
+ * @brief Pin the calling thread to the CPU for thread t of a team under the
+ * current policy; does nothing under None.
+ *
+ * Called by `parallel_for` for its worker threads.
+ */
+void pin_team_thread(unsigned t);
+
+#endif // THREAD_AFFINITY_H
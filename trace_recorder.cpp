@@ -0,0 +1,326 @@
+/**
+ * @file trace_recorder.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the call trace recorder.
+ *
+ * All file access happens under one mutex, so `stop_trace` cannot close a
+ * file under a call that is writing to it. Only sampled payloads make that
+ * lock noticeable; the plain lines are short single writes.
+ */
+
+#include "trace_recorder.h"
+#include "layout_convert.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+struct TraceState
+{
+    int fd = -1;
+    int payload_fd = -1;
+    unsigned payload_every = 0;
+    unsigned long long calls = 0;
+    unsigned long long generation = 0;
+    off_t payload_size = 0;
+    std::chrono::steady_clock::time_point origin;
+};
+
+std::mutex trace_mutex;
+TraceState state; ///< guarded by trace_mutex
+std::atomic<bool> active{false};
+
+void close_trace()
+{
+    active.store(false);
+    if (state.fd >= 0)
+        close(state.fd);
+    if (state.payload_fd >= 0)
+        close(state.payload_fd);
+    state.fd = -1;
+    state.payload_fd = -1;
+}
+
+void open_trace(const std::string &path, unsigned payload_every)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    close_trace();
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    const int fd = open(path.c_str(), flags | O_APPEND, 0644);
+    const int payload_fd =
+        payload_every != 0 ? open((path + ".payload").c_str(), flags, 0644)
+                           : -1;
+    if (fd < 0 || (payload_every != 0 && payload_fd < 0))
+    {
+        const std::string reason = std::strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        throw std::runtime_error("cannot create trace " + path + ": " +
+                                 reason);
+    }
+    state.fd = fd;
+    state.payload_fd = payload_fd;
+    state.payload_every = payload_every;
+    state.calls = 0;
+    state.payload_size = 0;
+    ++state.generation;
+    state.origin = std::chrono::steady_clock::now();
+    active.store(true);
+}
+
+bool start_from_environment()
+{
+    const char *path = std::getenv("EIGEN_TRACE");
+    if (path == nullptr || *path == '\0')
+        return false;
+    const char *every = std::getenv("EIGEN_TRACE_PAYLOAD_EVERY");
+    try
+    {
+        open_trace(path, every != nullptr ? std::strtoul(every, nullptr, 10)
+                                          : 0);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "EIGEN_TRACE: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool environment_checked()
+{
+    static const bool started = start_from_environment();
+    return started;
+}
+
+bool write_payload(int fd, off_t offset, const double *a, Eigen::Index m,
+                   Eigen::Index n, Eigen::Index lda)
+{
+    // A padded matrix is packed first, so the payload is a single write
+    thread_local std::vector<double> packed;
+    if (lda != m)
+    {
+        packed.resize(static_cast<std::size_t>(m) * n);
+        copy_matrix(a, lda, m, n, packed.data(), m);
+        a = packed.data();
+    }
+    const std::size_t bytes = static_cast<std::size_t>(m) * n * sizeof(double);
+    std::size_t done = 0;
+    while (done < bytes)
+    {
+        const ssize_t put =
+            pwrite(fd, reinterpret_cast<const char *>(a) + done,
+                   bytes - done, offset + done);
+        if (put <= 0)
+            return false;
+        done += put;
+    }
+    return true;
+}
+
+} // namespace
+
+const char *structure_name(MatrixStructure structure)
+{
+    switch (structure)
+    {
+    case MatrixStructure::Diagonal:
+        return "diagonal";
+    case MatrixStructure::UpperTriangular:
+        return "upper";
+    case MatrixStructure::LowerTriangular:
+        return "lower";
+    case MatrixStructure::Symmetric:
+        return "symmetric";
+    case MatrixStructure::General:
+        return "general";
+    }
+    return "unknown";
+}
+
+MatrixStructure parse_structure(const std::string &name)
+{
+    for (MatrixStructure structure :
+         {MatrixStructure::Diagonal, MatrixStructure::UpperTriangular,
+          MatrixStructure::LowerTriangular, MatrixStructure::Symmetric,
+          MatrixStructure::General})
+    {
+        if (name == structure_name(structure))
+            return structure;
+    }
+    throw std::invalid_argument("unknown matrix structure: " + name);
+}
+
+MatrixStructure classify_structure(const StructureProfile &profile)
+{
+    if (profile.diagonal())
+        return MatrixStructure::Diagonal;
+    if (profile.upper_triangular())
+        return MatrixStructure::UpperTriangular;
+    if (profile.lower_triangular())
+        return MatrixStructure::LowerTriangular;
+    return profile.symmetric ? MatrixStructure::Symmetric
+                             : MatrixStructure::General;
+}
+
+void start_trace(const std::string &path, unsigned payload_every)
+{
+    environment_checked();
+    open_trace(path, payload_every);
+}
+
+void stop_trace()
+{
+    environment_checked();
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    close_trace();
+}
+
+bool trace_active()
+{
+    environment_checked();
+    return active.load(std::memory_order_relaxed);
+}
+
+std::vector<TraceCall> read_trace(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("cannot open trace " + path + ": " +
+                                 std::strerror(errno));
+    }
+    std::string text;
+    char buffer[1 << 16];
+    ssize_t got;
+    while ((got = read(fd, buffer, sizeof buffer)) > 0)
+        text.append(buffer, got);
+    close(fd);
+    if (got < 0)
+    {
+        throw std::runtime_error("cannot read trace " + path + ": " +
+                                 std::strerror(errno));
+    }
+
+    std::vector<TraceCall> calls;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        std::istringstream fields(line);
+        TraceCall call;
+        std::string structure, end, extra;
+        if (!(fields >> call.start >> call.duration >> call.routine >>
+              call.m >> call.n >> structure >> call.job >> end))
+            continue;
+        if (end == "payload")
+            fields >> call.payload_offset >> end;
+        if (!fields || end != "end" || fields >> extra)
+            continue;
+        try
+        {
+            call.structure = parse_structure(structure);
+        }
+        catch (const std::invalid_argument &)
+        {
+            continue;
+        }
+        calls.push_back(std::move(call));
+    }
+    return calls;
+}
+
+bool read_trace_payload(const std::string &path, const TraceCall &call,
+                        Eigen::MatrixXd &A)
+{
+    if (call.payload_offset < 0)
+        return false;
+    const int fd = open((path + ".payload").c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    A.resize(call.m, call.n);
+    const std::size_t bytes = static_cast<std::size_t>(A.size()) *
+                              sizeof(double);
+    std::size_t done = 0;
+    while (done < bytes)
+    {
+        const ssize_t got =
+            pread(fd, reinterpret_cast<char *>(A.data()) + done,
+                  bytes - done, call.payload_offset + done);
+        if (got <= 0)
+            break;
+        done += got;
+    }
+    close(fd);
+    return done == bytes;
+}
+
+TraceCallScope::TraceCallScope(const char *routine, char job, const double *a,
+                               Eigen::Index m, Eigen::Index n,
+                               Eigen::Index lda)
+    : active_(trace_active())
+{
+    if (!active_)
+        return;
+    const auto arrival = std::chrono::steady_clock::now();
+    call_.routine = routine;
+    call_.m = m;
+    call_.n = n;
+    call_.job = job;
+    {
+        std::lock_guard<std::mutex> lock(trace_mutex);
+        if (state.fd < 0)
+        {
+            active_ = false;
+            return;
+        }
+        generation_ = state.generation;
+        call_.start =
+            std::chrono::duration<double>(arrival - state.origin).count();
+        const unsigned long long index = state.calls++;
+        if (state.payload_every != 0 && index % state.payload_every == 0 &&
+            write_payload(state.payload_fd, state.payload_size, a, m, n, lda))
+        {
+            call_.payload_offset = state.payload_size;
+            state.payload_size += static_cast<off_t>(m) * n * sizeof(double);
+        }
+    }
+    begin_ = std::chrono::steady_clock::now();
+}
+
+void TraceCallScope::done(const StructureProfile &profile)
+{
+    if (!active_)
+        return;
+    active_ = false;
+    call_.structure = classify_structure(profile);
+    call_.duration = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin_)
+                         .count();
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(9) << call_.start << ' '
+         << call_.duration << ' ' << call_.routine << ' ' << call_.m << ' '
+         << call_.n << ' ' << structure_name(call_.structure) << ' '
+         << call_.job;
+    if (call_.payload_offset >= 0)
+        line << " payload " << call_.payload_offset;
+    line << " end\n";
+    const std::string text = line.str();
+
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    if (state.fd >= 0 && state.generation == generation_ &&
+        write(state.fd, text.data(), text.size()) < 0)
+        std::cerr << "trace: " << std::strerror(errno) << std::endl;
+}
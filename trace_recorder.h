@@ -0,0 +1,161 @@
+/**
+ * @file trace_recorder.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the call trace recorder of the LAPACK
+ * interface and the reader used to replay its traces.
+ *
+ * While a trace is active, every `eigen_decomposition` (`dgeev`) and
+ * `svd_decomposition` (`dgesdd`) call appends one line to the trace file:
+ *
+ *     <start> <duration> <routine> <m> <n> <structure> <job>
+ *         [payload <offset>] end
+ *
+ * start is the arrival time of the call in seconds since the trace was
+ * started, duration the time spent in LAPACK, structure the shape of the
+ * input (see `MatrixStructure`) and job the LAPACK job character
+ * ('V' for `dgeev`, 'A', 'S' or 'N' for `dgesdd`). When payloads are
+ * sampled, every k-th call also stores its input matrix (m x n doubles,
+ * column-major) at the given byte offset of the file `<trace>.payload`.
+ *
+ * When no trace is active the recorder costs one atomic load per call. A
+ * trace is started with `start_trace`, or for an unmodified program by
+ * setting EIGEN_TRACE=<file> (and EIGEN_TRACE_PAYLOAD_EVERY=<k>) in the
+ * environment. Lines are written with a single append each, so a crash
+ * loses at most the line being written, which lacks its closing "end" and
+ * is skipped by `read_trace`.
+ */
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include "structure_analyzer.h"
+#include <Eigen/Dense>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The shape of a matrix, from the most to the least special.
+ */
+enum class MatrixStructure
+{
+    Diagonal,
+    UpperTriangular,
+    LowerTriangular,
+    Symmetric,
+    General
+};
+
+/**
+ * @brief The name of a structure: "diagonal", "upper", "lower", "symmetric"
+ * or "general".
+ */
+const char *structure_name(MatrixStructure structure);
+
+/**
+ * @brief The structure with the given name.
+ *
+ * @throws std::invalid_argument if the name is unknown.
+ */
+MatrixStructure parse_structure(const std::string &name);
+
+/**
+ * @brief The most special structure of a matrix analyzed by
+ * `analyze_structure`.
+ *
+ * Triangular and diagonal need exact zeros; symmetric needs a square matrix
+ * with exactly equal mirrored entries.
+ */
+MatrixStructure classify_structure(const StructureProfile &profile);
+
+/**
+ * @brief One recorded call.
+ */
+struct TraceCall
+{
+    double start = 0.0;    ///< seconds since the trace was started
+    double duration = 0.0; ///< seconds spent in LAPACK
+    std::string routine;   ///< "dgeev" or "dgesdd"
+    Eigen::Index m = 0;
+    Eigen::Index n = 0;
+    MatrixStructure structure = MatrixStructure::General;
+    char job = 'V';
+    long long payload_offset = -1; ///< -1 if the input was not sampled
+};
+
+/**
+ * @brief Start recording calls to a trace file, replacing any earlier
+ * trace in that file.
+ *
+ * A trace that is already active is stopped first.
+ *
+ * @param path The trace file; payloads go to path + ".payload".
+ * @param payload_every Store the input matrix of every k-th call, 0 for
+ * none.
+ * @throws std::runtime_error if the files cannot be created.
+ */
+void start_trace(const std::string &path, unsigned payload_every = 0);
+
+/**
+ * @brief Stop recording and close the trace files.
+ *
+ * Calls still in flight on other threads may be lost.
+ */
+void stop_trace();
+
+/**
+ * @brief Whether a trace is being recorded.
+ *
+ * The first call starts a trace named by EIGEN_TRACE if it is set.
+ */
+bool trace_active();
+
+/**
+ * @brief The complete calls of a trace file, in the order they finished.
+ *
+ * @throws std::runtime_error if the file cannot be read.
+ */
+std::vector<TraceCall> read_trace(const std::string &path);
+
+/**
+ * @brief Load the input matrix sampled with a call.
+ *
+ * @param path The trace file the call was read from.
+ * @param call The call.
+ * @param A The matrix that will store the input.
+ * @return false if the call has no payload or it cannot be read.
+ */
+bool read_trace_payload(const std::string &path, const TraceCall &call,
+                        Eigen::MatrixXd &A);
+
+/**
+ * @brief Records one LAPACK call of the interface if a trace is active.
+ *
+ * Construct it with the LAPACK input right before the call (the input may
+ * be destroyed by it) and call `done` with the structure of the input once
+ * the call succeeded; a call that throws is not recorded. The scope does
+ * not scan the input itself: the eigensolvers pass the profile they
+ * dispatched on.
+ */
+class TraceCallScope
+{
+  public:
+    TraceCallScope(const char *routine, char job, const double *a,
+                   Eigen::Index m, Eigen::Index n, Eigen::Index lda);
+
+    /**
+     * @brief Append the call to the trace.
+     *
+     * @param profile The analysis of the input.
+     */
+    void done(const StructureProfile &profile);
+
+  private:
+    bool active_;
+    unsigned long long generation_ = 0; ///< of the trace the call belongs to
+    TraceCall call_;
+    std::chrono::steady_clock::time_point begin_;
+};
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,352 @@
+/**
+ * @file trace_replay.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief Replay of a recorded call trace (see trace_recorder.h) against a
+ * chosen backend and scheduling configuration.
+ *
+ * The calls of the trace arrive at their recorded times, scaled by
+ * `--speed` (2 replays twice as fast, 0 issues every call at once). They
+ * are served in arrival order by `--workers` threads, so a call that
+ * arrives while all workers are busy waits, as it would in the recording
+ * service. Each call decomposes its sampled payload if the trace has one,
+ * otherwise a random matrix of the recorded size and structure.
+ *
+ * Backends: "fortran" calls `eigen_decomposition` and `svd_decomposition`,
+ * "eigen" uses Eigen's EigenSolver and BDCSVD, and "isolated" runs the
+ * `dgeev` calls in an `IsolatedExecutor` with one worker process per
+ * replay worker (its SVD calls run in process, as with "fortran").
+ *
+ * The report gives the latency from arrival to completion, including the
+ * wait for a free worker, and per call shape the recorded and replayed
+ * median run time.
+ *
+ * Usage: trace_replay TRACE [--backend=fortran|eigen|isolated]
+ *                     [--workers=N] [--threads=T] [--speed=X]
+ *                     [--policy=none|compact|scatter|physical|explicit]
+ *                     [--cpus=c,c,...] [--timeout-ms=MS]
+ */
+
+#include "blas_threads.h"
+#include "eigen_interface.h"
+#include "isolated_executor.h"
+#include "parallel.h"
+#include "thread_affinity.h"
+#include "trace_recorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+struct Options
+{
+    std::string trace;
+    std::string backend = "fortran";
+    unsigned workers = 1;
+    unsigned threads = 0; ///< 0 leaves the BLAS team as configured
+    double speed = 1.0;
+    std::string policy = "none";
+    std::vector<int> cpus;
+    long timeout_ms = 60000;
+};
+
+struct Outcome
+{
+    double latency = 0.0; ///< arrival to completion
+    double service = 0.0; ///< run time of the decomposition
+};
+
+using Shape = std::tuple<std::string, Eigen::Index, Eigen::Index,
+                         MatrixStructure, char>;
+
+Shape shape(const TraceCall &call)
+{
+    return Shape(call.routine, call.m, call.n, call.structure, call.job);
+}
+
+std::vector<std::string> split(const std::string &text, char separator)
+{
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator))
+        parts.push_back(part);
+    return parts;
+}
+
+Options parse_options(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const std::size_t eq = arg.find('=');
+        const std::string name = arg.substr(0, eq);
+        const std::string value =
+            eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (arg.compare(0, 2, "--") != 0 && options.trace.empty())
+            options.trace = arg;
+        else if (name == "--backend")
+        {
+            if (value != "fortran" && value != "eigen" && value != "isolated")
+                throw std::invalid_argument("unknown backend: " + value);
+            options.backend = value;
+        }
+        else if (name == "--workers")
+            options.workers = std::stoul(value);
+        else if (name == "--threads")
+            options.threads = std::stoul(value);
+        else if (name == "--speed")
+            options.speed = std::stod(value);
+        else if (name == "--policy")
+        {
+            parse_affinity_policy(value);
+            options.policy = value;
+        }
+        else if (name == "--cpus")
+        {
+            for (const std::string &s : split(value, ','))
+                options.cpus.push_back(std::stoi(s));
+        }
+        else if (name == "--timeout-ms")
+            options.timeout_ms = std::stol(value);
+        else
+            throw std::invalid_argument("unknown option: " + arg);
+    }
+    if (options.trace.empty())
+        throw std::invalid_argument("no trace file given");
+    if (options.workers == 0 || options.speed < 0.0)
+        throw std::invalid_argument("--workers must be positive and "
+                                    "--speed not negative");
+    if (options.policy == "explicit" && options.cpus.empty())
+        throw std::invalid_argument("the explicit policy needs --cpus");
+    return options;
+}
+
+/**
+ * @brief A random m x n matrix with the given structure.
+ */
+Eigen::MatrixXd synthetic_input(const TraceCall &call)
+{
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(call.m, call.n);
+    switch (call.structure)
+    {
+    case MatrixStructure::Diagonal:
+        A = Eigen::MatrixXd(A.triangularView<Eigen::Upper>())
+                .triangularView<Eigen::Lower>();
+        break;
+    case MatrixStructure::UpperTriangular:
+        A = Eigen::MatrixXd(A.triangularView<Eigen::Upper>());
+        break;
+    case MatrixStructure::LowerTriangular:
+        A = Eigen::MatrixXd(A.triangularView<Eigen::Lower>());
+        break;
+    case MatrixStructure::Symmetric:
+        A = (A + A.transpose()) / 2.0;
+        break;
+    case MatrixStructure::General:
+        break;
+    }
+    return A;
+}
+
+SvdMode svd_mode(char job)
+{
+    return job == 'A' ? SvdMode::Full
+                      : job == 'S' ? SvdMode::Thin : SvdMode::ValuesOnly;
+}
+
+void run_call(const Options &options, IsolatedExecutor *executor,
+              const TraceCall &call, const Eigen::MatrixXd &A)
+{
+    Eigen::VectorXd W;
+    Eigen::MatrixXd U, V;
+    if (call.routine == "dgeev")
+    {
+        if (options.backend == "eigen")
+        {
+            Eigen::EigenSolver<Eigen::MatrixXd> solver(A);
+            W = solver.eigenvalues().real();
+            V = solver.eigenvectors().real();
+        }
+        else if (executor != nullptr)
+        {
+            executor->eigen_decomposition(
+                A, W, V, std::chrono::milliseconds(options.timeout_ms));
+        }
+        else
+            eigen_decomposition(A, W, V);
+    }
+    else if (call.routine == "dgesdd")
+    {
+        if (options.backend == "eigen")
+        {
+            const unsigned flags =
+                call.job == 'A'
+                    ? Eigen::ComputeFullU | Eigen::ComputeFullV
+                    : call.job == 'S'
+                          ? Eigen::ComputeThinU | Eigen::ComputeThinV
+                          : 0;
+            Eigen::BDCSVD<Eigen::MatrixXd> svd(A, flags);
+            W = svd.singularValues();
+        }
+        else
+            svd_decomposition(A, W, U, V, svd_mode(call.job));
+    }
+    else
+        throw std::invalid_argument("cannot replay routine " + call.routine);
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[static_cast<std::size_t>(p * (values.size() - 1))];
+}
+
+} // namespace
+
+/**
+ * @brief The main entry point of the replay tool.
+ *
+ * @return Returns 0 if the program executed successfully, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const Options options = parse_options(argc, argv);
+        std::vector<TraceCall> calls = read_trace(options.trace);
+        if (calls.empty())
+            throw std::runtime_error("no complete calls in " + options.trace);
+        // Lines are written when calls finish; replay in arrival order
+        std::stable_sort(calls.begin(), calls.end(),
+                         [](const TraceCall &a, const TraceCall &b) {
+                             return a.start < b.start;
+                         });
+
+        // Inputs: the sampled payloads, one random matrix per other shape
+        std::vector<const Eigen::MatrixXd *> inputs(calls.size());
+        std::vector<Eigen::MatrixXd> payloads(calls.size());
+        std::map<Shape, Eigen::MatrixXd> synthetic;
+        std::size_t sampled = 0;
+        for (std::size_t i = 0; i < calls.size(); ++i)
+        {
+            if (read_trace_payload(options.trace, calls[i], payloads[i]))
+            {
+                inputs[i] = &payloads[i];
+                ++sampled;
+                continue;
+            }
+            auto found = synthetic.find(shape(calls[i]));
+            if (found == synthetic.end())
+                found = synthetic
+                            .emplace(shape(calls[i]),
+                                     synthetic_input(calls[i]))
+                            .first;
+            inputs[i] = &found->second;
+        }
+
+        if (options.threads != 0)
+            set_blas_threads(options.threads);
+        std::unique_ptr<IsolatedExecutor> executor;
+        if (options.backend == "isolated")
+            executor.reset(new IsolatedExecutor(options.workers));
+        // Start the BLAS team before placing it
+        run_call(options, nullptr, calls.front(), *inputs.front());
+        apply_placement(
+            {parse_affinity_policy(options.policy), options.cpus});
+
+        std::vector<Outcome> outcomes(calls.size());
+        std::atomic<std::size_t> next{0};
+        const auto origin = std::chrono::steady_clock::now();
+        const double first = calls.front().start;
+        parallel_for(
+            options.workers,
+            [&](std::size_t, std::size_t) {
+                for (std::size_t i = next++; i < calls.size(); i = next++)
+                {
+                    const double offset =
+                        options.speed > 0.0
+                            ? (calls[i].start - first) / options.speed
+                            : 0.0;
+                    const auto arrival =
+                        origin + std::chrono::duration_cast<
+                                     std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double>(offset));
+                    std::this_thread::sleep_until(arrival);
+                    const auto begin = std::chrono::steady_clock::now();
+                    run_call(options, executor.get(), calls[i], *inputs[i]);
+                    const auto end = std::chrono::steady_clock::now();
+                    outcomes[i].latency =
+                        std::chrono::duration<double>(end - arrival).count();
+                    outcomes[i].service =
+                        std::chrono::duration<double>(end - begin).count();
+                }
+            },
+            options.workers);
+        const double wall = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - origin)
+                                .count();
+
+        std::vector<double> latencies;
+        std::map<Shape, std::pair<std::vector<double>, std::vector<double>>>
+            by_shape; // recorded and replayed run times
+        for (std::size_t i = 0; i < calls.size(); ++i)
+        {
+            latencies.push_back(outcomes[i].latency);
+            auto &times = by_shape[shape(calls[i])];
+            times.first.push_back(calls[i].duration);
+            times.second.push_back(outcomes[i].service);
+        }
+
+        std::cout << "Replayed " << calls.size() << " calls (" << sampled
+                  << " with payload) from " << options.trace << " on "
+                  << options.backend << ", " << options.workers
+                  << " workers, " << blas_threads() << " BLAS threads, policy "
+                  << options.policy << ", speed " << options.speed << "\n";
+        std::cout << "Trace span " << calls.back().start - first
+                  << " s, replay wall time " << wall << " s, "
+                  << calls.size() / wall << " calls/s\n";
+        std::cout << "Latency [s]: p50 " << percentile(latencies, 0.5)
+                  << ", p95 " << percentile(latencies, 0.95) << ", p99 "
+                  << percentile(latencies, 0.99) << ", max "
+                  << percentile(latencies, 1.0) << "\n\n";
+        std::cout << std::setw(8) << "routine" << std::setw(7) << "m"
+                  << std::setw(7) << "n" << std::setw(11) << "structure"
+                  << std::setw(5) << "job" << std::setw(8) << "calls"
+                  << std::setw(14) << "recorded [s]" << std::setw(14)
+                  << "replayed [s]" << std::endl;
+        for (const auto &entry : by_shape)
+        {
+            const Shape &s = entry.first;
+            std::cout << std::setw(8) << std::get<0>(s) << std::setw(7)
+                      << std::get<1>(s) << std::setw(7) << std::get<2>(s)
+                      << std::setw(11) << structure_name(std::get<3>(s))
+                      << std::setw(5) << std::get<4>(s) << std::setw(8)
+                      << entry.second.first.size() << std::setw(14)
+                      << std::setprecision(6)
+                      << percentile(entry.second.first, 0.5) << std::setw(14)
+                      << percentile(entry.second.second, 0.5) << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in trace replay: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,342 @@
+/**
+ * @file workspace_pool.cpp
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This file contains the definition of the size-class workspace pool.
+ */
+
+#include "workspace_pool.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief The byte sizes of all size classes, each a multiple of 64.
+ */
+const std::vector<std::size_t> &class_table()
+{
+    static const std::vector<std::size_t> table = [] {
+        std::vector<std::size_t> sizes;
+        double size = WorkspacePool::min_class_bytes;
+        // up to 2^44 bytes, far beyond anything LAPACK will be asked for
+        while (size < std::ldexp(1.0, 44))
+        {
+            const auto bytes = static_cast<std::size_t>(std::ceil(size));
+            sizes.push_back((bytes + 63) / 64 * 64);
+            size *= WorkspacePool::class_growth;
+        }
+        return sizes;
+    }();
+    return table;
+}
+
+/** Whether this thread's cache has already been destroyed (thread exit). */
+thread_local bool thread_cache_destroyed = false;
+
+void *allocate_block(std::size_t bytes)
+{
+    void *p = std::aligned_alloc(64, bytes);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+} // namespace
+
+WorkspaceLease::WorkspaceLease(WorkspaceLease &&other) noexcept
+    : pool_(other.pool_), ptr_(other.ptr_), bytes_(other.bytes_),
+      size_class_(other.size_class_)
+{
+    other.pool_ = nullptr;
+    other.ptr_ = nullptr;
+    other.bytes_ = 0;
+    other.size_class_ = -1;
+}
+
+WorkspaceLease &WorkspaceLease::operator=(WorkspaceLease &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        std::swap(pool_, other.pool_);
+        std::swap(ptr_, other.ptr_);
+        std::swap(bytes_, other.bytes_);
+        std::swap(size_class_, other.size_class_);
+    }
+    return *this;
+}
+
+WorkspaceLease::~WorkspaceLease()
+{
+    release();
+}
+
+void WorkspaceLease::release()
+{
+    if (ptr_ != nullptr)
+        pool_->release(ptr_, bytes_, size_class_);
+    pool_ = nullptr;
+    ptr_ = nullptr;
+    bytes_ = 0;
+    size_class_ = -1;
+}
+
+/**
+ * @brief The blocks a thread has recently released to the process-wide pool.
+ *
+ * Only the owning thread touches it, so no locking is needed. Slots are kept
+ * in release order, the oldest first; on thread exit everything goes back to
+ * the global free list.
+ */
+struct WorkspacePool::ThreadCache
+{
+    struct Slot
+    {
+        void *ptr;
+        std::size_t bytes;
+        int size_class;
+    };
+
+    std::array<Slot, thread_cache_slots> slots;
+    int count = 0;
+
+    ~ThreadCache()
+    {
+        WorkspacePool::instance().flush(*this);
+        thread_cache_destroyed = true;
+    }
+};
+
+WorkspacePool &WorkspacePool::instance()
+{
+    // Never destroyed: thread caches may flush into it during exit.
+    static WorkspacePool *pool = new WorkspacePool();
+    return *pool;
+}
+
+WorkspacePool::WorkspacePool(std::size_t memory_cap) : memory_cap_(memory_cap)
+{
+}
+
+WorkspacePool::~WorkspacePool()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &entry : free_)
+    {
+        for (const Block &block : entry.second)
+            std::free(block.ptr);
+    }
+}
+
+int WorkspacePool::size_class(std::size_t bytes)
+{
+    const auto &table = class_table();
+    auto it = std::lower_bound(table.begin(), table.end(), bytes);
+    if (it == table.end())
+        throw std::bad_alloc();
+    return static_cast<int>(it - table.begin());
+}
+
+std::size_t WorkspacePool::class_bytes(int size_class)
+{
+    return class_table()[size_class];
+}
+
+WorkspacePool::ThreadCache *WorkspacePool::thread_cache()
+{
+    // Leases held by other thread_local objects can be released after the
+    // cache is gone; those blocks go straight to the global list.
+    if (this != &instance() || thread_cache_destroyed)
+        return nullptr;
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+WorkspaceLease WorkspacePool::acquire(std::size_t bytes)
+{
+    const int cls = size_class(bytes);
+    const std::size_t block_bytes = class_bytes(cls);
+
+    ThreadCache *cache =
+        block_bytes <= thread_cache_max_bytes ? thread_cache() : nullptr;
+    if (cache != nullptr)
+    {
+        // newest first: it is the most likely to still be in cache
+        for (int i = cache->count - 1; i >= 0; --i)
+        {
+            if (cache->slots[i].size_class != cls)
+                continue;
+            void *ptr = cache->slots[i].ptr;
+            std::copy(cache->slots.begin() + i + 1,
+                      cache->slots.begin() + cache->count,
+                      cache->slots.begin() + i);
+            --cache->count;
+            thread_cached_bytes_ -= block_bytes;
+            leased_bytes_ += block_bytes;
+            ++thread_hits_;
+            return WorkspaceLease(this, ptr, block_bytes, cls);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = free_.find(cls);
+        if (it != free_.end())
+        {
+            void *ptr = it->second.back().ptr;
+            it->second.pop_back();
+            if (it->second.empty())
+                free_.erase(it);
+            stats_.idle_bytes -= block_bytes;
+            ++stats_.global_hits;
+            leased_bytes_ += block_bytes;
+            return WorkspaceLease(this, ptr, block_bytes, cls);
+        }
+        ++stats_.misses;
+    }
+
+    void *ptr = allocate_block(block_bytes);
+    leased_bytes_ += block_bytes;
+    return WorkspaceLease(this, ptr, block_bytes, cls);
+}
+
+unsigned WorkspacePool::prefault(std::size_t bytes, unsigned count)
+{
+    const std::size_t block_bytes = class_bytes(size_class(bytes));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t room = memory_cap_ > stats_.idle_bytes
+                                     ? memory_cap_ - stats_.idle_bytes
+                                     : 0;
+        count = static_cast<unsigned>(
+            std::min<std::size_t>(count, room / block_bytes));
+    }
+    // Hold all leases at once so that count distinct blocks are touched.
+    std::vector<WorkspaceLease> leases;
+    leases.reserve(count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        leases.push_back(acquire(bytes));
+        std::memset(leases.back().ptr_, 0, leases.back().bytes_);
+    }
+    // Bypass the thread cache: the blocks are meant for any thread.
+    for (WorkspaceLease &lease : leases)
+    {
+        leased_bytes_ -= lease.bytes_;
+        release_global(lease.ptr_, lease.bytes_, lease.size_class_);
+        lease.ptr_ = nullptr;
+    }
+    return count;
+}
+
+void WorkspacePool::release(void *ptr, std::size_t bytes, int size_class)
+{
+    leased_bytes_ -= bytes;
+    ThreadCache *cache =
+        bytes <= thread_cache_max_bytes ? thread_cache() : nullptr;
+    if (cache == nullptr)
+    {
+        release_global(ptr, bytes, size_class);
+        return;
+    }
+
+    if (cache->count == thread_cache_slots)
+    {
+        const ThreadCache::Slot oldest = cache->slots[0];
+        std::copy(cache->slots.begin() + 1, cache->slots.end(),
+                  cache->slots.begin());
+        --cache->count;
+        thread_cached_bytes_ -= oldest.bytes;
+        release_global(oldest.ptr, oldest.bytes, oldest.size_class);
+    }
+    cache->slots[cache->count++] = {ptr, bytes, size_class};
+    thread_cached_bytes_ += bytes;
+}
+
+void WorkspacePool::release_global(void *ptr, std::size_t bytes,
+                                   int size_class)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_[size_class].push_back({ptr, ++clock_});
+    stats_.idle_bytes += bytes;
+    if (stats_.idle_bytes > memory_cap_)
+        trim_locked(memory_cap_);
+}
+
+void WorkspacePool::trim_locked(std::size_t target_bytes)
+{
+    while (stats_.idle_bytes > target_bytes)
+    {
+        // the least recently released block is at the front of some class
+        auto oldest = free_.end();
+        std::uint64_t oldest_time = std::numeric_limits<std::uint64_t>::max();
+        for (auto it = free_.begin(); it != free_.end(); ++it)
+        {
+            if (it->second.front().released_at < oldest_time)
+            {
+                oldest_time = it->second.front().released_at;
+                oldest = it;
+            }
+        }
+        std::free(oldest->second.front().ptr);
+        oldest->second.pop_front();
+        stats_.idle_bytes -= class_bytes(oldest->first);
+        ++stats_.trimmed;
+        if (oldest->second.empty())
+            free_.erase(oldest);
+    }
+}
+
+void WorkspacePool::trim(std::size_t target_bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    trim_locked(target_bytes);
+}
+
+void WorkspacePool::set_memory_cap(std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    memory_cap_ = bytes;
+    trim_locked(memory_cap_);
+}
+
+std::size_t WorkspacePool::memory_cap() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory_cap_;
+}
+
+void WorkspacePool::flush_thread_cache()
+{
+    if (ThreadCache *cache = thread_cache())
+        flush(*cache);
+}
+
+void WorkspacePool::flush(ThreadCache &cache)
+{
+    for (int i = 0; i < cache.count; ++i)
+    {
+        thread_cached_bytes_ -= cache.slots[i].bytes;
+        release_global(cache.slots[i].ptr, cache.slots[i].bytes,
+                       cache.slots[i].size_class);
+    }
+    cache.count = 0;
+}
+
+WorkspacePool::Stats WorkspacePool::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s = stats_;
+    s.leased_bytes = leased_bytes_;
+    s.thread_cached_bytes = thread_cached_bytes_;
+    s.thread_hits = thread_hits_;
+    return s;
+}
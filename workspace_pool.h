@@ -0,0 +1,222 @@
+/**
+ * @file workspace_pool.h
+ * @author Roman Wallner-Silberhubere
+ * @date 18.10.2026
+ * @brief This header file defines the process-wide pool from which the
+ * LAPACK wrappers lease their workspaces.
+ *
+ * Services that decompose matrices of many different sizes on many threads
+ * cannot keep one workspace per thread sized for the largest n forever, nor
+ * reallocate on every call. `WorkspacePool` rounds every request up to a size
+ * class (powers of 1.25, starting at 4 KiB) and recycles released blocks:
+ * - each thread keeps a few recently released blocks of up to 1 MiB in a
+ *   private cache that is accessed without any locking;
+ * - everything else goes to a global free list, guarded by a mutex, whose
+ *   idle memory is bounded by a cap; when the cap is exceeded the least
+ *   recently released blocks are freed first.
+ */
+
+#ifndef WORKSPACE_POOL_H
+#define WORKSPACE_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+
+class WorkspacePool;
+
+/**
+ * @brief A block of 64-byte aligned memory leased from a `WorkspacePool`.
+ *
+ * The block is returned to the pool when the lease is destroyed. Leases are
+ * move-only.
+ */
+class WorkspaceLease
+{
+  public:
+    WorkspaceLease() = default;
+    WorkspaceLease(WorkspaceLease &&other) noexcept;
+    WorkspaceLease &operator=(WorkspaceLease &&other) noexcept;
+    WorkspaceLease(const WorkspaceLease &) = delete;
+    WorkspaceLease &operator=(const WorkspaceLease &) = delete;
+    ~WorkspaceLease();
+
+    /**
+     * @brief The leased memory, viewed as doubles.
+     */
+    double *data() const
+    {
+        return static_cast<double *>(ptr_);
+    }
+
+    /**
+     * @brief Usable size of the block in bytes (the full size class).
+     */
+    std::size_t bytes() const
+    {
+        return bytes_;
+    }
+
+    explicit operator bool() const
+    {
+        return ptr_ != nullptr;
+    }
+
+    /**
+     * @brief Return the block to the pool early.
+     */
+    void release();
+
+  private:
+    friend class WorkspacePool;
+    WorkspaceLease(WorkspacePool *pool, void *ptr, std::size_t bytes,
+                   int size_class)
+        : pool_(pool), ptr_(ptr), bytes_(bytes), size_class_(size_class)
+    {
+    }
+
+    WorkspacePool *pool_ = nullptr;
+    void *ptr_ = nullptr;
+    std::size_t bytes_ = 0;
+    int size_class_ = -1;
+};
+
+/**
+ * @brief Size-class based pool of aligned workspace blocks.
+ */
+class WorkspacePool
+{
+  public:
+    /**
+     * @brief Counters describing the state of the pool.
+     */
+    struct Stats
+    {
+        std::size_t idle_bytes = 0;   ///< in the global free list
+        std::size_t leased_bytes = 0; ///< currently leased out
+        std::size_t thread_cached_bytes = 0;
+        std::uint64_t thread_hits = 0; ///< served from a thread cache
+        std::uint64_t global_hits = 0; ///< served from the global list
+        std::uint64_t misses = 0;      ///< newly allocated
+        std::uint64_t trimmed = 0;     ///< blocks freed to honour the cap
+    };
+
+    /** Smallest size class in bytes. */
+    static constexpr std::size_t min_class_bytes = 4096;
+    /** Growth factor between consecutive size classes. */
+    static constexpr double class_growth = 1.25;
+    /** Blocks kept per thread before they go to the global list. */
+    static constexpr int thread_cache_slots = 4;
+    /**
+     * Larger blocks bypass the thread caches. Cached blocks are not counted
+     * against the memory cap, so this bounds them to 4 MiB per thread; a
+     * workspace above it serves an O(n^3) call that dwarfs the mutex.
+     */
+    static constexpr std::size_t thread_cache_max_bytes = std::size_t(1)
+                                                          << 20;
+
+    /**
+     * @brief The process-wide pool used by the LAPACK wrappers.
+     */
+    static WorkspacePool &instance();
+
+    /**
+     * @brief Create a pool whose global free list holds at most memory_cap
+     * idle bytes.
+     */
+    explicit WorkspacePool(std::size_t memory_cap = std::size_t(1) << 30);
+    ~WorkspacePool();
+    WorkspacePool(const WorkspacePool &) = delete;
+    WorkspacePool &operator=(const WorkspacePool &) = delete;
+
+    /**
+     * @brief Lease a block of at least the given number of bytes.
+     *
+     * @throws std::bad_alloc if the memory cannot be allocated.
+     */
+    WorkspaceLease acquire(std::size_t bytes);
+
+    /**
+     * @brief Lease a block of at least count doubles.
+     */
+    WorkspaceLease acquire_doubles(std::size_t count)
+    {
+        return acquire(count * sizeof(double));
+    }
+
+    /**
+     * @brief Put count blocks of at least the given number of bytes into the
+     * global free list, with every page already touched.
+     *
+     * Fresh memory is only mapped on first access, so the first call that
+     * uses a new workspace pays one page fault per 4 KiB. Prefaulting moves
+     * that cost to start-up. The blocks count against the memory cap, and
+     * only as many are prefaulted as fit under it next to the idle memory
+     * already held: more would be freed again right away. Raise the cap
+     * with `set_memory_cap` first to warm a larger set.
+     *
+     * @return The number of blocks prefaulted, at most count.
+     */
+    unsigned prefault(std::size_t bytes, unsigned count = 1);
+
+    /**
+     * @brief Change the cap on idle memory, trimming immediately if needed.
+     */
+    void set_memory_cap(std::size_t bytes);
+
+    std::size_t memory_cap() const;
+
+    /**
+     * @brief Free least recently used idle blocks until at most target_bytes
+     * are idle in the global free list.
+     */
+    void trim(std::size_t target_bytes = 0);
+
+    /**
+     * @brief Return the calling thread's cached blocks to the global list.
+     *
+     * Only the process-wide `instance()` uses thread caches; blocks of other
+     * pools always go to their global list.
+     */
+    void flush_thread_cache();
+
+    Stats stats() const;
+
+    /**
+     * @brief The size class of a request, and the bytes of a size class.
+     */
+    static int size_class(std::size_t bytes);
+    static std::size_t class_bytes(int size_class);
+
+  private:
+    friend class WorkspaceLease;
+    struct ThreadCache;
+
+    struct Block
+    {
+        void *ptr;
+        std::uint64_t released_at; ///< logical clock, for LRU trimming
+    };
+
+    void release(void *ptr, std::size_t bytes, int size_class);
+    void release_global(void *ptr, std::size_t bytes, int size_class);
+    void trim_locked(std::size_t target_bytes);
+    void flush(ThreadCache &cache);
+    ThreadCache *thread_cache();
+
+    mutable std::mutex mutex_;
+    std::map<int, std::list<Block>> free_; ///< per size class, oldest first
+    std::size_t memory_cap_;
+    std::uint64_t clock_ = 0;
+    Stats stats_; ///< idle_bytes, global_hits, misses and trimmed
+
+    // Updated by the lock-free thread cache path.
+    std::atomic<std::size_t> leased_bytes_{0};
+    std::atomic<std::size_t> thread_cached_bytes_{0};
+    std::atomic<std::uint64_t> thread_hits_{0};
+};
+
+#endif // WORKSPACE_POOL_H